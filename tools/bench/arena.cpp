@@ -0,0 +1,56 @@
+/*
+ * Stress run of SegmentArena with ESP8266 limits: random effect/layout changes free and allocate
+ * segment data of 1-2048 bytes while total data stays within MAX_SEGMENT_DATA (as enforced by
+ * Segment::allocateData()). Every allocation within that budget has to succeed; data contents are
+ * verified after each compaction moved them.
+ * Run with: tools/bench/run.sh arena
+ */
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define MAX_NUM_SEGMENTS 16   // ESP8266
+#define MAX_SEGMENT_DATA 5120 // ESP8266
+
+struct Segment { // only what SegmentArena::compact() touches, plus test bookkeeping
+  uint8_t *data;
+  size_t   len;
+  uint8_t  tag;
+};
+
+#include "arena.inc" // SegmentArena extracted from wled00 by run.sh
+
+int main() {
+  static SegmentArena arena;
+  Segment seg[MAX_NUM_SEGMENTS] = {};
+  size_t used = 0;
+  unsigned long allocs = 0, failures = 0, overBudget = 0;
+  unsigned worstFrag = 0;
+  srand(42);
+
+  for (long it = 0; it < 2000000; it++) {
+    Segment &s = seg[rand() % MAX_NUM_SEGMENTS];
+    if (s.data) { // effect or layout change: verify and release previous data
+      for (size_t k = 0; k < s.len; k++) if (s.data[k] != s.tag) { printf("data corrupted after compaction\n"); return 1; }
+      arena.free(s.data);
+      used -= s.len;
+      s.data = nullptr;
+    }
+    size_t len = (rand() % 4 == 0) ? 1 + rand() % 2048 : 1 + rand() % 400;
+    if (used + len > MAX_SEGMENT_DATA) { overBudget++; continue; } // rejected by allocateData() before reaching arena
+    allocs++;
+    s.data = arena.alloc(len, &s, true);
+    if (!s.data) { failures++; continue; }
+    s.len = len;
+    s.tag = rand();
+    memset(s.data, s.tag, len);
+    used += len;
+    unsigned frag = arena.getFragmentation();
+    if (frag > worstFrag) worstFrag = frag;
+  }
+
+  printf("allocations %lu (over budget skipped %lu), failed %lu, compactions %u (%.1f%%), worst fragmentation %u%%\n",
+    allocs, overBudget, failures, arena.getCompactions(), 100.0 * arena.getCompactions() / allocs, worstFrag);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,91 @@
+/*
+ * Realtime jitter buffer simulation: the receive task side (publishRealtimeRxFrame()) and the main
+ * loop side (handleRealtimeRxFrames(), scheduleRealtimeRxFrame()) are extracted from e131.cpp and
+ * driven by a simulated clock. A 40 fps sender with +-10 ms arrival jitter is received with a
+ * 1 ms main loop, without (frames shown on arrival) and with a 2 frame jitter buffer.
+ * Reports the standard deviation of the interval between shown frames.
+ * Run with: tools/bench/run.sh jitter
+ */
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include "frame_ring.h"
+
+typedef uint8_t byte;
+typedef void   *TaskHandle_t;
+typedef struct { uint8_t raw[638]; } e131_packet_t; // only its size matters here
+
+#define LEDS        16
+#define FRAMES      2000
+#define INTERVAL_US 25000 // 40 fps
+#define JITTER_MS   10
+
+static uint32_t nowUs = 0;
+static uint32_t micros() { return nowUs; }
+static uint32_t millis() { return nowUs / 1000; }
+
+uint32_t rtRxFramesSkipped = 0;
+uint8_t  realtimeJitterFrames = 0;
+uint16_t realtimeJitterLatency = 0;
+uint32_t rtJitterLate = 0;
+uint32_t rtJitterEarly = 0;
+byte     realtimeMode = 1;
+bool     realtimeOverride = false;
+void realtimeLock(uint32_t timeoutMs, byte md) {} // sender is already in realtime mode
+
+struct WS2812FX {
+  std::vector<uint32_t> shown; // times of show()
+  uint32_t lastShow = 0;
+  void setPixelColors(int i, uint16_t count, const uint32_t *c) {}
+  void show() { shown.push_back(nowUs); lastShow = millis(); }
+  uint32_t getLastShow() const { return lastShow; }
+} strip;
+
+#include "jitter.inc" // receive frame ring and jitter buffer extracted from e131.cpp by run.sh
+
+static void simulate(uint8_t jitterFrames, const std::vector<uint32_t> &arrivals) {
+  realtimeJitterFrames = jitterFrames;
+  rtRxFramesSkipped = rtJitterLate = rtJitterEarly = 0;
+  strip.shown.clear();
+  rtRxFrames.begin(RT_RX_FRAME_SLOTS + realtimeJitterFrames, sizeof(rt_rx_frame_t) + LEDS * sizeof(uint32_t));
+  rtRxTaskHandle = &rtRxFrames; // task is "running"
+  rtRxLo = 0;
+  rtRxHi = LEDS;
+
+  size_t next = 0;
+  for (nowUs = 0; nowUs < arrivals.back() + 200000; nowUs += 1000) {
+    while (next < arrivals.size() && arrivals[next] <= nowUs) { // frame completed by receive task
+      uint32_t loopTime = nowUs;
+      nowUs = arrivals[next++];
+      publishRealtimeRxFrame();
+      nowUs = loopTime;
+    }
+    handleRealtimeRxFrames();
+  }
+
+  double sum = 0, sum2 = 0;
+  size_t n = 0;
+  for (size_t i = 100; i < strip.shown.size(); i++, n++) { // skip start-up
+    double d = strip.shown[i] - strip.shown[i-1];
+    sum  += d;
+    sum2 += d * d;
+  }
+  double mean = sum / n;
+  printf("jbuf %u: shown %zu, skipped %u, late %u, early %u, interval mean %.1f ms, sd %.1f ms\n",
+    jitterFrames, strip.shown.size(), rtRxFramesSkipped, rtJitterLate, rtJitterEarly, mean / 1000, sqrt(sum2 / n - mean * mean) / 1000);
+}
+
+int main() {
+  std::vector<uint32_t> arrivals;
+  srand(1);
+  for (int i = 0; i < FRAMES; i++) arrivals.push_back(1000000 + i * INTERVAL_US + (rand() % (2 * JITTER_MS + 1) - JITTER_MS) * 1000);
+  std::sort(arrivals.begin(), arrivals.end());
+
+  simulate(0, arrivals);
+  simulate(2, arrivals);
+  return 0;
+}
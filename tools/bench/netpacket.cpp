@@ -0,0 +1,69 @@
+/*
+ * Realtime sender payload preparation (realtimeBroadcast()): previous path writing each channel
+ * through a virtual per byte UDP write() with scale8(), against color_scale_bytes() into a prebuilt
+ * packet handed over with one copy. Also checks color_scale_bytes() against scale8() for every
+ * brightness and source alignment.
+ * 2000 RGB pixels, 1440 channels per packet (DDP/Art-Net sized), 10 byte header.
+ * Run with: tools/bench/run.sh netpacket
+ */
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+
+static inline uint8_t scale8(uint8_t i, uint8_t s) { return ((uint16_t)i * (1 + (uint16_t)s)) >> 8; } // FastLED (FASTLED_SCALE8_FIXED)
+
+#include "netpacket.inc" // kernels extracted from wled00 by run.sh
+
+#define CHANNELS   (2000*3)
+#define PACKET_LEN 1440
+#define HEADER_LEN 10
+#define FRAMES     5000
+
+struct Print { virtual size_t write(uint8_t b) = 0; virtual ~Print() {} };        // stand-in for WiFiUDP
+struct Loopback : Print {
+  uint8_t buf[HEADER_LEN + PACKET_LEN];
+  size_t  n = 0;
+  size_t write(uint8_t b) override { if (n < sizeof(buf)) buf[n++] = b; return 1; }
+};
+
+int main() {
+  uint8_t *data = (uint8_t*) malloc(CHANNELS);
+  for (size_t i = 0; i < CHANNELS; i++) data[i] = rand();
+
+  uint8_t out[PACKET_LEN + 4];
+  for (unsigned bri = 0; bri < 256; bri++) for (size_t off = 0; off < 4; off++) {
+    color_scale_bytes(out + off, data + off, PACKET_LEN - 3, bri);
+    for (size_t i = 0; i < PACKET_LEN - 3; i++) if (out[off+i] != scale8(data[off+i], bri)) { printf("color_scale_bytes mismatch\n"); return 1; }
+  }
+  printf("color_scale_bytes() identical to scale8()\n");
+
+  Loopback udp;
+  Print *sink = &udp;
+  uint8_t packet[HEADER_LEN + PACKET_LEN] = {0};
+  volatile uint8_t keep = 0;
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (int f = 0; f < FRAMES; f++) for (size_t c = 0; c < CHANNELS; c += PACKET_LEN) {
+    size_t n = CHANNELS - c < PACKET_LEN ? CHANNELS - c : PACKET_LEN;
+    udp.n = 0;
+    for (size_t h = 0; h < HEADER_LEN; h++) sink->write(packet[h]);
+    for (size_t i = 0; i < n; i++) sink->write(scale8(data[c+i], 200));
+    keep = udp.buf[HEADER_LEN];
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  for (int f = 0; f < FRAMES; f++) for (size_t c = 0; c < CHANNELS; c += PACKET_LEN) {
+    size_t n = CHANNELS - c < PACKET_LEN ? CHANNELS - c : PACKET_LEN;
+    color_scale_bytes(packet + HEADER_LEN, data + c, n, 200);
+    memcpy(udp.buf, packet, HEADER_LEN + n); // single submit of the whole packet
+    keep = udp.buf[HEADER_LEN];
+  }
+  auto t2 = std::chrono::steady_clock::now();
+  (void)keep;
+
+  auto us = [](auto a, auto b) { return std::chrono::duration<double, std::micro>(b - a).count() / FRAMES; };
+  printf("per byte write %.2f us/frame, prebuilt packet %.2f us/frame\n", us(t0, t1), us(t1, t2));
+  free(data);
+  return 0;
+}
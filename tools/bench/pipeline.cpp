@@ -0,0 +1,57 @@
+/*
+ * Bus transmission pipelining (hw.led.pipe) with the real TaskWorker (std::thread backend):
+ * 200 frames of 1.5 ms rendering followed by a 2 ms transmission, once with transmission posted to the
+ * worker (as BusManager::show() does when pipelining) and once inline. Also checks that isBusy()
+ * reports the job from post() on, before the worker picked it up.
+ * Run with: tools/bench/run.sh pipeline
+ */
+#include <cstdio>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "task_worker.h"
+
+#define FRAMES    200
+#define RENDER_US 1500
+#define TX_US     2000
+
+static std::atomic<int> transmitted{0};
+
+static void transmit(void *) {
+  std::this_thread::sleep_for(std::chrono::microseconds(TX_US));
+  transmitted++;
+}
+
+static double run(TaskWorker &worker, uint64_t &stallUs) {
+  auto t0 = std::chrono::steady_clock::now();
+  stallUs = 0;
+  for (int f = 0; f < FRAMES; f++) {
+    std::this_thread::sleep_for(std::chrono::microseconds(RENDER_US)); // render next frame
+    worker.post(transmit, nullptr); // waits for previous transmission first
+    stallUs += worker.getWaitTime();
+  }
+  worker.wait();
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main() {
+  TaskWorker worker;
+  worker.begin("busTx");
+  uint64_t stallUs;
+
+  worker.post(transmit, nullptr);
+  if (!worker.isBusy()) { printf("isBusy() false right after post()\n"); return 1; }
+  worker.wait();
+  if (worker.isBusy()) { printf("isBusy() true after wait()\n"); return 1; }
+
+  transmitted = 0;
+  double pipelined = run(worker, stallUs);
+  printf("pipelined: %d frames in %.0f ms, avg stall %.0f us\n", transmitted.load(), pipelined, (double)stallUs / FRAMES);
+  worker.end();
+
+  TaskWorker inlineWorker; // not started: jobs run inline from post()
+  transmitted = 0;
+  double serial = run(inlineWorker, stallUs);
+  printf("inline:    %d frames in %.0f ms\n", transmitted.load(), serial);
+  return 0;
+}
@@ -0,0 +1,85 @@
+/*
+ * Cost and scaling of the parallel segment rendering dispatch (WS2812FX::renderParallel()):
+ * segments are split by pixel count between the calling thread and 1..3 TaskWorkers (the real
+ * task_worker.cpp, std::thread backend), each worker rendering with its own render context.
+ * The effect is a synthetic per pixel workload, segments are 16 x 600 px.
+ * Scaling can only show on a machine with more than one CPU; on a single CPU the difference
+ * between 1 and N workers is the dispatch overhead.
+ * Run with: tools/bench/run.sh render
+ */
+#include <cstdio>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "task_worker.h"
+
+#define NUM_SEGMENTS 16
+#define SEGMENT_LEN  600
+#define MAX_WORKERS  4
+#define FRAMES       2000
+
+struct RenderContext { uint8_t segmentIndex; uint16_t virtualLength; };
+static RenderContext ctx[MAX_WORKERS];
+static thread_local uint8_t renderContextId = 0; // as in FX.h host builds
+#define CTX ctx[renderContextId]
+
+struct Segment { std::vector<uint32_t> pixels; uint32_t call = 0; };
+static std::vector<Segment> segments(NUM_SEGMENTS);
+
+static void effect() { // plasma-like per pixel work on SEGMENT
+  Segment &seg = segments[CTX.segmentIndex];
+  for (uint16_t i = 0; i < CTX.virtualLength; i++) {
+    float v = sinf(i * 0.05f + seg.call * 0.1f) + cosf(i * 0.031f - seg.call * 0.07f);
+    uint8_t b = (v + 2.f) * 63.f;
+    seg.pixels[i] = (b << 16) | ((255 - b) << 8);
+  }
+  seg.call++;
+}
+
+static void renderSegments(uint32_t mask) {
+  for (size_t i = 0; i < segments.size(); i++) {
+    if (!(mask & (1UL << i))) continue;
+    CTX.segmentIndex  = i;
+    CTX.virtualLength = segments[i].pixels.size();
+    effect();
+  }
+}
+
+struct RenderJob { uint32_t segments; uint8_t context; };
+static RenderJob jobs[MAX_WORKERS-1];
+
+static void renderJob(void *arg) {
+  RenderJob *j = static_cast<RenderJob*>(arg);
+  renderContextId = j->context;
+  renderSegments(j->segments);
+}
+
+int main() {
+  for (auto &s : segments) s.pixels.resize(SEGMENT_LEN);
+  TaskWorker worker[MAX_WORKERS-1];
+  for (auto &w : worker) w.begin("render");
+  printf("%u CPU(s)\n", std::thread::hardware_concurrency());
+
+  for (int workers = 1; workers <= MAX_WORKERS; workers *= 2) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int f = 0; f < FRAMES; f++) {
+      uint32_t load[MAX_WORKERS] = {0}, share[MAX_WORKERS] = {0};
+      for (size_t i = 0; i < segments.size(); i++) { // same split as renderParallel()
+        int k = 0;
+        for (int w = 1; w < workers; w++) if (load[w] < load[k]) k = w;
+        share[k] |= 1UL << i;
+        load[k]  += segments[i].pixels.size();
+      }
+      for (int k = 1; k < workers; k++) {
+        jobs[k-1] = {share[k], (uint8_t)k};
+        worker[k-1].post(renderJob, &jobs[k-1]);
+      }
+      renderSegments(share[0]);
+      for (int k = 1; k < workers; k++) worker[k-1].wait();
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / FRAMES;
+    printf("%d render context(s): %.0f us/frame\n", workers, us);
+  }
+  return 0;
+}
@@ -0,0 +1,100 @@
+/*
+ * Realtime ingest (DDP/E1.31/Art-Net/UDP realtime receive): setRealtimePixel() per pixel against
+ * setRealtimePixels() in chunks, both extracted from udp.cpp. strip and busses are stand-ins that
+ * follow WS2812FX::setPixelColor()/setPixelColors() and BusManager::setPixelColor()/setPixelColors()
+ * (bus lookup, one virtual call per pixel resp. per chunk); no ledmap, gamma correction on.
+ * Also checks that both paths produce the same bus contents.
+ * 2000 RGB pixels on one bus.
+ * Run with: tools/bench/run.sh rtingest
+ */
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+
+typedef uint8_t byte;
+#define RGBW32(r,g,b,w) (uint32_t((byte(w) << 24) | (byte(r) << 16) | (byte(g) << 8) | (byte(b))))
+
+#define LEDS   2000
+#define FRAMES 20000
+
+static uint8_t gammaT[256];
+#define gamma8(c) gammaT[c]
+
+int  arlsOffset = 0;
+bool arlsDisableGammaCorrection = false;
+bool gammaCorrectCol = true;
+bool useMainSegmentOnly = false;
+bool realtimeRxSetPixels(uint16_t pix, uint16_t count, const uint32_t *c) { return false; } // no realtime receive task
+
+struct Bus {
+  uint32_t pixels[LEDS];
+  uint16_t start = 0, len = LEDS;
+  virtual void setPixelColor(uint16_t pix, uint32_t c) { pixels[pix] = c; }
+  virtual void setPixelColors(uint16_t pix, uint16_t count, const uint32_t *c) { memcpy(pixels + pix, c, count * sizeof(uint32_t)); }
+  virtual ~Bus() {}
+};
+
+struct BusManager {
+  Bus *busses[1];
+  uint8_t numBusses = 1;
+  __attribute__((noinline)) void setPixelColor(uint16_t pix, uint32_t c) {
+    for (uint8_t i = 0; i < numBusses; i++) {
+      Bus *b = busses[i];
+      if (pix < b->start || pix >= b->start + b->len) continue;
+      b->setPixelColor(pix - b->start, c);
+    }
+  }
+  __attribute__((noinline)) void setPixelColors(uint16_t pix, uint16_t count, const uint32_t *c) {
+    uint32_t end = pix + count;
+    for (uint8_t i = 0; i < numBusses; i++) {
+      Bus *b = busses[i];
+      uint32_t from = b->start > pix ? b->start : pix;
+      uint32_t to   = b->start + b->len < end ? b->start + b->len : end;
+      if (from < to) b->setPixelColors(from - b->start, to - from, c + (from - pix));
+    }
+  }
+} busses;
+
+struct Segment {
+  uint16_t length() const { return LEDS; }
+  void setPixelColor(int i, uint32_t c) {}
+};
+
+struct WS2812FX {
+  Segment main;
+  uint16_t getLengthTotal() const { return LEDS; }
+  Segment &getMainSegment() { return main; }
+  __attribute__((noinline)) void setPixelColor(int i, uint32_t c) { if (i < LEDS) busses.setPixelColor(i, c); }
+  __attribute__((noinline)) void setPixelColors(int i, uint16_t count, const uint32_t *c) { busses.setPixelColors(i, count, c); }
+} strip;
+
+void setRealtimePixels(uint16_t start, uint16_t count, const uint8_t *data, uint8_t channelsPerPixel, bool applyOffset = true); // as in fcn_declare.h
+#include "rtingest.inc" // setRealtimePixel() and setRealtimePixels() extracted from udp.cpp by run.sh
+
+int main() {
+  for (int i = 0; i < 256; i++) gammaT[i] = i * i / 255;
+  static uint8_t data[LEDS * 3];
+  for (int i = 0; i < LEDS * 3; i++) data[i] = i * 7;
+  static Bus bus;
+  static uint32_t ref[LEDS];
+  busses.busses[0] = &bus;
+
+  for (int i = 0; i < LEDS; i++) setRealtimePixel(i, data[i*3], data[i*3+1], data[i*3+2], 0);
+  memcpy(ref, bus.pixels, sizeof(ref));
+  memset(bus.pixels, 0, sizeof(bus.pixels));
+  setRealtimePixels(0, LEDS, data, 3);
+  if (memcmp(ref, bus.pixels, sizeof(ref))) { printf("setRealtimePixels() differs from setRealtimePixel()\n"); return 1; }
+  printf("bulk and per pixel ingest identical\n");
+
+  using clock = std::chrono::steady_clock;
+  auto t0 = clock::now();
+  for (int f = 0; f < FRAMES; f++) for (int i = 0; i < LEDS; i++) setRealtimePixel(i, data[i*3], data[i*3+1], data[i*3+2], 0);
+  auto t1 = clock::now();
+  for (int f = 0; f < FRAMES; f++) setRealtimePixels(0, LEDS, data, 3);
+  auto t2 = clock::now();
+
+  auto us = [](auto a, auto b) { return std::chrono::duration<double, std::micro>(b - a).count() / FRAMES; };
+  printf("per pixel %.2f us/frame, bulk %.2f us/frame\n", us(t0, t1), us(t1, t2));
+  return 0;
+}
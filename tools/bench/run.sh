@@ -0,0 +1,71 @@
+#!/bin/bash
+# Host (x86/ARM Linux) checks and micro benchmarks for WLED code that does not need the Arduino framework.
+# Kernels are extracted from the current wled00 sources, so results always refer to the tree as it is.
+# Numbers are only meant for comparing old and new code paths on the same machine, not for device timings.
+#
+# usage: tools/bench/run.sh <name>    builds and runs tools/bench/<name>.cpp
+#   spans      color_*_span() kernels vs. per pixel CRGB reference (exactness + ns/pixel)
+#   arena      SegmentArena stress run with ESP8266 limits (failed allocations, compactions, data integrity)
+#   pipeline   bus transmission pipelining over TaskWorker vs. inline (frame time, stall)
+#   render     parallel segment rendering dispatch over TaskWorker threads (us/frame for 1, 2 and 4 contexts)
+#   netpacket  realtime sender payload: per byte UDP write() vs. color_scale_bytes() into prebuilt packet
+#   framering  FrameRing producer/consumer thread stress test (use -fsanitize=thread to check for races)
+#   rtingest   realtime receive: setRealtimePixel() per pixel vs. setRealtimePixels() (us/frame)
+#   jitter     realtime jitter buffer simulation, interval between shown frames with and without buffering
+#
+# CXX and CXXFLAGS may be overridden (default -Os like firmware builds; at -O2 host compilers vectorize
+# the per pixel reference loops, which the ESP compilers cannot), binaries are placed in BENCH_OUT (default /tmp/wled_bench).
+set -e
+
+BENCH=$(cd "$(dirname "$0")" && pwd)
+SRC="$BENCH/../../wled00"
+OUT=${BENCH_OUT:-/tmp/wled_bench}
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:--Os}
+
+# prints each top level block (function, class or one line definition) of file $1 whose first line matches regex $2
+extract() {
+  awk -v pat="$2" '!p && $0 ~ pat { print; p = ($0 !~ /[{].*[}];?[ \t]*$/); next } p { print } p && /^}/ { p = 0 }' "$1"
+}
+
+NAME=$1
+if [ -z "$NAME" ] || [ ! -f "$BENCH/$NAME.cpp" ]; then
+  sed -n '/^# usage/,/^#$/p' "$0"
+  exit 1
+fi
+mkdir -p "$OUT"
+SOURCES=()
+
+case "$NAME" in
+  spans|netpacket)
+    { extract "$SRC/fcn_declare.h" '^inline uint32_t color_(scale8x4|qadd8x4)[(]'
+      extract "$SRC/colors.cpp"    '^void color_[a-z_]+[(]'
+    } > "$OUT/$NAME.inc"
+    ;;
+  arena)
+    { grep -h 'define SEGMENT_ARENA_SIZE' "$SRC/FX.h"
+      extract "$SRC/FX.h"       '^class SegmentArena'
+      extract "$SRC/FX_fcn.cpp" '^[a-z].*SegmentArena::[a-zA-Z]+[(]'
+    } > "$OUT/$NAME.inc"
+    ;;
+  rtingest)
+    { grep -h 'define REALTIME_CHUNK_PIXELS' "$SRC/udp.cpp"
+      extract "$SRC/udp.cpp" '^void setRealtimePixels?[(]'
+    } > "$OUT/$NAME.inc"
+    ;;
+  jitter)
+    { grep -h -E '^#define RT_RX_(FRAME_SLOTS|MAX_GAP)' "$SRC/e131.cpp"
+      extract "$SRC/e131.cpp" '^typedef struct'
+      grep -h -E '^static +[A-Za-z_0-9:<>]+ +(rtRx|jb)' "$SRC/e131.cpp"
+      extract "$SRC/e131.cpp" '^static inline uint32_t [*]rtRxFramePixels'
+      extract "$SRC/e131.cpp" '^static void (publish|show|schedule)RealtimeRxFrame[(]'
+      extract "$SRC/e131.cpp" '^void handleRealtimeRxFrames[(][)] [{]$'
+    } > "$OUT/$NAME.inc"
+    ;;
+  pipeline|render)
+    SOURCES=("$SRC/task_worker.cpp")
+    ;;
+esac
+
+$CXX -std=c++17 $CXXFLAGS -I "$OUT" -I "$SRC" -o "$OUT/$NAME" "$BENCH/$NAME.cpp" "${SOURCES[@]}" -lpthread
+"$OUT/$NAME"
@@ -0,0 +1,78 @@
+/*
+ * Checks color_scale8x4(), color_qadd8x4(), color_scale_span() and color_blur_span() against
+ * per pixel reference implementations of FastLED scale8()/qadd8()/nscale8()/blur1d() on CRGB
+ * and compares their speed on a 1024 pixel buffer.
+ * Run with: tools/bench/run.sh spans
+ */
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+
+// FastLED reference (FASTLED_SCALE8_FIXED), also used by the extracted kernels
+static inline uint8_t scale8(uint8_t i, uint8_t s) { return ((uint16_t)i * (1 + (uint16_t)s)) >> 8; }
+static inline uint8_t qadd8(uint8_t a, uint8_t b)  { unsigned t = a + b; return t > 255 ? 255 : t; }
+
+#include "spans.inc" // kernels extracted from wled00 by run.sh
+
+struct RGB { uint8_t r, g, b; };
+static inline RGB      toRGB(uint32_t c) { return { uint8_t(c >> 16), uint8_t(c >> 8), uint8_t(c) }; }
+static inline uint32_t fromRGB(RGB c)    { return (uint32_t(c.r) << 16) | (uint32_t(c.g) << 8) | c.b; }
+static inline RGB      scale(RGB c, uint8_t s) { return { scale8(c.r, s), scale8(c.g, s), scale8(c.b, s) }; }
+static inline RGB      add(RGB a, RGB b)       { return { qadd8(a.r, b.r), qadd8(a.g, b.g), qadd8(a.b, b.b) }; }
+
+// previous Segment::fadeToBlackBy()/nscale8() path: getPixelColor() -> CRGB::nscale8() -> setPixelColor()
+static void refScale(uint32_t *px, size_t len, uint8_t s) {
+  for (size_t i = 0; i < len; i++) px[i] = fromRGB(scale(toRGB(px[i]), s));
+}
+
+// previous Segment::blur() path (FastLED blur1d() semantics)
+static void refBlur(uint32_t *px, size_t len, uint8_t amount) {
+  uint8_t keep = 255 - amount, seep = amount >> 1;
+  RGB carryover = {0, 0, 0};
+  for (size_t i = 0; i < len; i++) {
+    RGB cur = toRGB(px[i]), before = cur;
+    RGB part = scale(cur, seep);
+    cur = add(scale(cur, keep), carryover);
+    if (i > 0) px[i-1] = fromRGB(add(toRGB(px[i-1]), part));
+    if (memcmp(&before, &cur, sizeof(RGB))) px[i] = fromRGB(cur);
+    carryover = part;
+  }
+}
+
+int main() {
+  // exhaustive check of the SWAR helpers, every channel value against every scale/addend
+  for (unsigned a = 0; a < 256; a++) for (unsigned b = 0; b < 256; b++) {
+    uint32_t A = a * 0x01010101U, B = b * 0x01010101U;
+    if (color_qadd8x4(A, B)  != qadd8(a, b)  * 0x01010101U) { printf("color_qadd8x4 mismatch %u %u\n", a, b); return 1; }
+    if (color_scale8x4(A, b) != scale8(a, b) * 0x01010101U) { printf("color_scale8x4 mismatch %u %u\n", a, b); return 1; }
+  }
+
+  // random buffers, span kernels against per pixel path (white is dropped by the CRGB path)
+  const size_t N = 1024;
+  static uint32_t x[N], y[N];
+  srand(1);
+  for (int t = 0; t < 2000; t++) {
+    for (size_t i = 0; i < N; i++) x[i] = y[i] = rand() ^ (rand() << 16);
+    uint8_t amount = rand();
+    for (size_t i = 0; i < N; i++) y[i] &= 0x00FFFFFFU;
+    refBlur(y, N, amount);
+    color_blur_span(x, N, 1, amount);
+    for (size_t i = 0; i < N; i++) if ((x[i] & 0x00FFFFFFU) != y[i]) { printf("color_blur_span mismatch\n"); return 1; }
+    refScale(y, N, amount);
+    color_scale_span(x, N, 1, amount);
+    for (size_t i = 0; i < N; i++) if (x[i] != y[i]) { printf("color_scale_span mismatch\n"); return 1; }
+  }
+  printf("results identical to per pixel reference\n");
+
+  const int R = 20000;
+  auto nsPerPx = [&](auto f) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < R; r++) f();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / (double(R) * N);
+  };
+  printf("scale: per pixel %.2f ns/px, span %.2f ns/px\n", nsPerPx([&]{ refScale(y, N, 200); }), nsPerPx([&]{ color_scale_span(x, N, 1, 200); }));
+  printf("blur:  per pixel %.2f ns/px, span %.2f ns/px\n", nsPerPx([&]{ refBlur(y, N, 100); }),  nsPerPx([&]{ color_blur_span(x, N, 1, 100); }));
+  return 0;
+}
@@ -30,6 +30,8 @@
 #include <vector>
 
 #include "const.h"
+#include "task_worker.h"
+#include "timing_stat.h"
 
 #define FASTLED_INTERNAL //remove annoying pragma messages
 #define USE_GET_MILLISECOND_TIMER
@@ -59,6 +61,9 @@
 /* Not used in all effects yet */
 #define WLED_FPS         42
 #define FRAMETIME_FIXED  (1000/WLED_FPS)
+#ifndef WLED_MAX_FPS
+  #define WLED_MAX_FPS   1000 // above 125 FPS frames are paced in us (high refresh); actual rate is also limited by bus transmit time
+#endif
 //#define FRAMETIME        _frametime
 #define FRAMETIME        strip.getFrameTime()
 
@@ -79,20 +84,65 @@
   #endif
 #endif
 
+/* Each segment using palettes keeps a pre-interpolated 256 entry palette (~820 bytes)
+  so color_from_palette() does not have to decode the palette for every pixel.
+  Not enabled on ESP8266 due to lack of RAM. */
+#if !defined(ESP8266) && !defined(WLED_DISABLE_PALETTE_CACHE)
+  #define WLED_ENABLE_PALETTE_CACHE
+#endif
+
+/* Segment runtime data (SEGENV.data) is allocated from a fixed, compacting arena instead of heap
+  so that cycling effects and segment layouts cannot fragment heap. Enabled by default on ESP8266,
+  use -D WLED_ENABLE_SEGMENT_ARENA to use it on ESP32 or -D WLED_DISABLE_SEGMENT_ARENA to disable. */
+#if defined(ESP8266) && !defined(WLED_DISABLE_SEGMENT_ARENA) && !defined(WLED_ENABLE_SEGMENT_ARENA)
+  #define WLED_ENABLE_SEGMENT_ARENA
+#endif
+#ifdef WLED_ENABLE_SEGMENT_ARENA
+  // room for MAX_SEGMENT_DATA plus a block header and alignment padding for each segment
+  #define SEGMENT_ARENA_SIZE (MAX_SEGMENT_DATA + MAX_NUM_SEGMENTS * 24)
+#endif
+
+/* Number of tasks that may render segments concurrently (WS2812FX::parallelRendering), each uses
+  its own render context behind SEGMENT, SEGLEN, SEGCOLOR & SEGPALETTE macros. */
+#ifndef WLED_RENDER_WORKERS
+  #if defined(ARDUINO_ARCH_ESP32) && !defined(CONFIG_FREERTOS_UNICORE)
+    #define WLED_RENDER_WORKERS 2 // one per core
+  #elif !defined(ARDUINO)
+    #define WLED_RENDER_WORKERS 4 // host build
+  #else
+    #define WLED_RENDER_WORKERS 1
+  #endif
+#endif
+#if WLED_RENDER_WORKERS > 1
+  #if defined(ARDUINO_ARCH_ESP32) && WLED_RENDER_WORKERS > 2
+    #error "ESP32 supports at most 2 render workers (one per core)."
+  #endif
+  // context 0 for every task (loop(), async web server, ...) unless it is a render worker job that selected its own
+  extern thread_local uint8_t renderContextId;
+  #define RENDER_CONTEXT_ID() renderContextId
+#else
+  #define RENDER_CONTEXT_ID() 0
+#endif
+
+// effect benchmark (FX_bench.cpp): 1D 300/1500/5000 and 2D 16x16/32x32/64x64, each plain and with grouping 2 + mirror
+#define BENCH_LAYOUT_COUNT 12
+#define BENCH_MAX_FRAMES   200
+#define BENCH_NO_RESULT    0xFFFF // layout or effect skipped (reserved effect, 2D unavailable, out of memory)
+
 /* How much data bytes each segment should max allocate to leave enough space for other segments,
   assuming each segment uses the same amount of data. 256 for ESP8266, 640 for ESP32. */
 #define FAIR_DATA_PER_SEG (MAX_SEGMENT_DATA / strip.getMaxSegments())
 
-#define MIN_SHOW_DELAY   (_frametime < 16 ? 8 : 15)
+#define MIN_SHOW_DELAY   (_frametime < 16 ? (_frametime < 8 ? _frametime : 8) : 15)
 
 #define NUM_COLORS       3 /* number of colors per segment */
-#define SEGMENT          strip._segments[strip.getCurrSegmentId()]
-#define SEGENV           strip._segments[strip.getCurrSegmentId()]
+#define SEGMENT          strip.getCurrSegment()
+#define SEGENV           strip.getCurrSegment()
 //#define SEGCOLOR(x)      strip._segments[strip.getCurrSegmentId()].currentColor(x, strip._segments[strip.getCurrSegmentId()].colors[x])
 //#define SEGLEN           strip._segments[strip.getCurrSegmentId()].virtualLength()
 #define SEGCOLOR(x)      strip.segColor(x) /* saves us a few kbytes of code */
-#define SEGPALETTE       strip._currentPalette
-#define SEGLEN           strip._virtualSegmentLength /* saves us a few kbytes of code */
+#define SEGPALETTE       strip._ctx[RENDER_CONTEXT_ID()].palette
+#define SEGLEN           strip._ctx[RENDER_CONTEXT_ID()].virtualLength /* saves us a few kbytes of code */
 #define SPEED_FORMULA_L  (5U + (50U*(255U - SEGMENT.speed))/SEGLEN)
 
 // some common colors
@@ -329,6 +379,47 @@ typedef enum mapping1D2D {
   M12_pCorner = 3
 } mapping1D2D_t;
 
+#ifdef WLED_ENABLE_SEGMENT_ARENA
+struct Segment;
+
+/*
+ * Fixed size allocator for segment runtime data. Blocks are laid out back to back, each preceded by
+ * a header holding its size and owning segment. Free space is reused first fit; if no gap is large
+ * enough, used blocks are moved down (compacted) and their owner's data pointer is updated.
+ * Effects access their data through SEGENV.data on each call, so relocation is transparent as long
+ * as compaction only happens from the main loop (WS2812FX::service()).
+ */
+class SegmentArena {
+  public:
+    SegmentArena() : _top(0), _compactions(0) {}
+
+    uint8_t *alloc(size_t len, Segment *owner, bool canCompact);
+    void     free(uint8_t *p);
+    void     setOwner(uint8_t *p, Segment *owner); // has to be called when segment owning data is moved
+    void     compact(void);
+
+    size_t   getFree(void) const;          // total unused bytes
+    size_t   getLargestFree(void) const;   // largest contiguous unused bytes
+    uint8_t  getFragmentation(void) const; // 0-100%, 0 if all unused space is contiguous
+    inline uint16_t getCompactions(void) const { return _compactions; }
+
+  private:
+    static constexpr size_t ALIGN = 8; // alignment of returned data, effects cast it to structs
+
+    typedef struct {
+      uint16_t size;    // payload size in bytes (multiple of ALIGN)
+      Segment *owner;   // segment which data points to payload, nullptr if block is free
+    } Block;
+    static constexpr size_t HDR = (sizeof(Block) + ALIGN - 1) & ~(ALIGN - 1);
+
+    alignas(8) uint8_t _mem[SEGMENT_ARENA_SIZE];
+    size_t   _top;         // end of last block
+    uint16_t _compactions;
+
+    void coalesce(void);   // merges adjacent free blocks and releases trailing free space
+};
+#endif
+
 // segment, 80 bytes
 typedef struct Segment {
   public:
@@ -373,7 +464,7 @@ typedef struct Segment {
     char    *name;
 
     // runtime data
-    unsigned long next_time;  // millis() of next update
+    unsigned long next_time;  // micros() of next update (0: as soon as possible)
     uint32_t step;  // custom "step" var
     uint32_t call;  // call counter
     uint16_t aux0;  // custom var
@@ -394,6 +485,31 @@ typedef struct Segment {
     };
     uint16_t        _dataLen;
     static uint16_t _usedSegmentData;
+    static volatile bool _resetPending; // a segment was marked for reset since last WS2812FX::service() pass
+  #ifdef WLED_ENABLE_SEGMENT_ARENA
+    static SegmentArena _arena;
+  #endif
+  #if WLED_RENDER_WORKERS > 1
+    static TaskMutex    _dataLock; // effects may allocate data concurrently
+  #endif
+
+    // segment-local framebuffer in virtual coordinates (only if strip.useSegmentBuffers), composited in WS2812FX::show()
+    uint32_t       *_buf;
+    uint16_t        _bufLen;  // number of pixels in _buf
+
+    // precomputed virtual to physical pixel mapping of a 1D segment, rebuilt by updateGeometryMap() if geometry changes
+    // header is followed by vLen * stride physical (bus) pixel indices (0xFFFF if pixel is not set)
+    struct GeometryMap {
+      uint16_t start, stop, offset; // segment geometry the map was built for
+      uint8_t  grouping, spacing;
+      uint8_t  flags;               // reverse & mirror
+      uint8_t  gen;                 // strip mapping generation (ledmap, matrix, busses)
+      uint16_t vLen;                // number of virtual pixels
+      uint16_t stride;              // physical pixels per virtual pixel (grouping, doubled if mirrored)
+    } *_map;
+    uint8_t         _opacityT;      // effective opacity (including transition), updated once per frame
+    TimingStat      _fxTime;        // effect function execution time (reset when effect changes)
+    uint8_t         _throttle;      // frames skipped between renders, set by frame rate governor
 
     // perhaps this should be per segment, not static
     static CRGBPalette16 _randomPalette;
@@ -435,6 +551,15 @@ typedef struct Segment {
       }
     } *_t;
 
+  #ifdef WLED_ENABLE_PALETTE_CACHE
+    // expanded palette used by color_from_palette(), rebuilt when source palette or blending changes (820 bytes)
+    struct PaletteCache {
+      CRGBPalette16 _src;       // palette the table was expanded from
+      TBlendType    _blendType; // blending used for expansion
+      CRGB          _lut[256];  // full brightness colors for each palette index
+    } *_pc;
+  #endif
+
   public:
 
     Segment(uint16_t sStart=0, uint16_t sStop=30) :
@@ -468,7 +593,15 @@ typedef struct Segment {
       data(nullptr),
       _capabilities(0),
       _dataLen(0),
+      _buf(nullptr),
+      _bufLen(0),
+      _map(nullptr),
+      _opacityT(255),
+      _throttle(0),
       _t(nullptr)
+    #ifdef WLED_ENABLE_PALETTE_CACHE
+      ,_pc(nullptr)
+    #endif
     {
       //refreshLightCapabilities();
     }
@@ -490,14 +623,23 @@ typedef struct Segment {
       //#endif
       if (name) { delete[] name; name = nullptr; }
       if (_t)   { transitional = false; delete _t; _t = nullptr; }
+      #ifdef WLED_ENABLE_PALETTE_CACHE
+      if (_pc)  { delete _pc; _pc = nullptr; }
+      #endif
       deallocateData();
+      deallocateBuffer();
+      deallocateGeometryMap();
     }
 
     Segment& operator= (const Segment &orig); // copy assignment
     Segment& operator= (Segment &&orig) noexcept; // move assignment
 
 #ifdef WLED_DEBUG
+  #ifdef WLED_ENABLE_PALETTE_CACHE
+    size_t getSize() const { return sizeof(Segment) + (data?_dataLen:0) + (name?strlen(name):0) + (_t?sizeof(Transition):0) + (_pc?sizeof(PaletteCache):0); }
+  #else
     size_t getSize() const { return sizeof(Segment) + (data?_dataLen:0) + (name?strlen(name):0) + (_t?sizeof(Transition):0); }
+  #endif
 #endif
 
     inline bool     getOption(uint8_t n) const { return ((options >> n) & 0x01); }
@@ -511,10 +653,20 @@ typedef struct Segment {
     inline uint16_t height(void)         const { return stopY - startY; }                   // segment height (if 2D) in physical pixels (it *is* always >=1)
     inline uint16_t length(void)         const { return width() * height(); }               // segment length (count) in physical pixels
     inline uint16_t groupLength(void)    const { return grouping + spacing; }
+  #ifndef WLED_DISABLE_2D
+    inline bool     usesMatrix(void)     const { return is2D() || (Segment::maxHeight>1 && start < Segment::maxWidth*Segment::maxHeight); } // 2D segment or 1D segment within matrix
+  #else
+    inline bool     usesMatrix(void)     const { return false; }
+  #endif
     inline uint8_t  getLightCapabilities(void) const { return _capabilities; }
 
     static uint16_t getUsedSegmentData(void)    { return _usedSegmentData; }
     static void     addUsedSegmentData(int len) { _usedSegmentData += len; }
+    static bool     isResetPending(void)        { return _resetPending; }
+    static void     clearResetPending(void)     { _resetPending = false; }
+  #ifdef WLED_ENABLE_SEGMENT_ARENA
+    static const SegmentArena &getDataArena(void) { return _arena; }
+  #endif
     static void     handleRandomPalette();
 
     void    setUp(uint16_t i1, uint16_t i2, uint8_t grp=1, uint8_t spc=0, uint16_t ofs=UINT16_MAX, uint16_t i1Y=0, uint16_t i2Y=1, uint8_t segId = 255);
@@ -538,7 +690,25 @@ typedef struct Segment {
       * Call resetIfRequired before calling the next effect function.
       * Safe to call from interrupts and network requests.
       */
-    inline void markForReset(void) { reset = true; }  // setOption(SEG_OPTION_RESET, true)
+    inline void markForReset(void) { reset = true; _resetPending = true; }  // setOption(SEG_OPTION_RESET, true)
+
+    // segment-local framebuffer functions
+    inline bool   hasBuffer(void)  const { return _buf != nullptr; }
+    inline size_t bufferSize(void) const { return _buf ? _bufLen * sizeof(uint32_t) : 0; }
+    bool allocateBuffer(void);  // (re)allocates framebuffer to match current virtual size; call from main loop only
+    void deallocateBuffer(void);
+    void drawBuffer(bool clear = false); // writes framebuffer (or black if clear) to physical pixels
+    size_t spanLength(void) const;      // number of framebuffer pixels bulk operations may process directly (0 = use per-pixel path)
+
+    inline TimingStat &getEffectTime(void) { return _fxTime; } // effect function execution time (us)
+    inline uint8_t getThrottle(void) const { return _throttle; }
+    inline void    setThrottle(uint8_t t)  { _throttle = t; }
+
+    // precomputed geometry & opacity
+    void   updateGeometryMap(void); // (re)builds mapping if geometry changed; call from main loop only
+    void   deallocateGeometryMap(void);
+    inline size_t geometryMapSize(void) const { return _map ? sizeof(GeometryMap) + _map->vLen * _map->stride * sizeof(uint16_t) : 0; }
+    inline void   refreshOpacity(void) { _opacityT = currentBri(on ? opacity : 0); }
 
     // transition functions
     void     startTransition(uint16_t dur); // transition has to start before actual segment values change
@@ -549,6 +719,7 @@ typedef struct Segment {
     uint32_t currentColor(uint8_t slot, uint32_t colorNew);
     CRGBPalette16 &loadPalette(CRGBPalette16 &tgt, uint8_t pal);
     CRGBPalette16 &currentPalette(CRGBPalette16 &tgt, uint8_t paletteID);
+    void     updatePaletteCache(const CRGBPalette16 &pal, bool create = false);
 
     // 1D strip
     uint16_t virtualLength(void) const;
@@ -558,6 +729,7 @@ typedef struct Segment {
     void setPixelColor(float i, uint32_t c, bool aa = true);
     void setPixelColor(float i, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0, bool aa = true) { setPixelColor(i, RGBW32(r,g,b,w), aa); }
     void setPixelColor(float i, CRGB c, bool aa = true)                                         { setPixelColor(i, RGBW32(c.r,c.g,c.b,0), aa); }
+    void paintPixel(int i, uint32_t c); // writes virtual pixel to physical pixels (bypasses framebuffer)
     uint32_t getPixelColor(int i);
     // 1D support functions (some implement 2D as well)
     void blur(uint8_t);
@@ -586,6 +758,7 @@ typedef struct Segment {
     void setPixelColorXY(float x, float y, uint32_t c, bool aa = true);
     void setPixelColorXY(float x, float y, byte r, byte g, byte b, byte w = 0, bool aa = true) { setPixelColorXY(x, y, RGBW32(r,g,b,w), aa); }
     void setPixelColorXY(float x, float y, CRGB c, bool aa = true)                             { setPixelColorXY(x, y, RGBW32(c.r,c.g,c.b,0), aa); }
+    void paintPixelXY(int x, int y, uint32_t c); // writes virtual pixel to physical pixels (bypasses framebuffer)
     uint32_t getPixelColorXY(uint16_t x, uint16_t y);
     // 2D support functions
     void blendPixelColorXY(uint16_t x, uint16_t y, uint32_t color, uint8_t blend);
@@ -620,6 +793,7 @@ typedef struct Segment {
     void setPixelColorXY(float x, float y, uint32_t c, bool aa = true)     { setPixelColor(x, c, aa); }
     void setPixelColorXY(float x, float y, byte r, byte g, byte b, byte w = 0, bool aa = true) { setPixelColor(x, RGBW32(r,g,b,w), aa); }
     void setPixelColorXY(float x, float y, CRGB c, bool aa = true)         { setPixelColor(x, RGBW32(c.r,c.g,c.b,0), aa); }
+    void paintPixelXY(int x, int y, uint32_t c)                            { paintPixel(x, c); }
     uint32_t getPixelColorXY(uint16_t x, uint16_t y)                       { return getPixelColor(x); }
     void blendPixelColorXY(uint16_t x, uint16_t y, uint32_t c, uint8_t blend) { blendPixelColor(x, c, blend); }
     void blendPixelColorXY(uint16_t x, uint16_t y, CRGB c, uint8_t blend)  { blendPixelColor(x, RGBW32(c.r,c.g,c.b,0), blend); }
@@ -643,6 +817,16 @@ typedef struct Segment {
 } segment;
 //static int segSize = sizeof(Segment);
 
+// state effect functions access through SEGMENT, SEGLEN, SEGCOLOR & SEGPALETTE (one per render worker)
+typedef struct RenderContext {
+  CRGBPalette16 palette;            // palette used for current effect (includes transition)
+  uint32_t      colors[NUM_COLORS]; // colors used for current effect (includes transition)
+  uint16_t      virtualLength;      // virtual length of current segment
+  uint8_t       segmentIndex;       // segment currently being rendered
+  Segment      *segment;            // segment being rendered (nullptr outside of rendering: _segments[segmentIndex])
+  RenderContext() : palette(CRGBPalette16(CRGB::Black)), colors{0,0,0}, virtualLength(0), segmentIndex(0), segment(nullptr) {}
+} render_context_t;
+
 // main "strip" class
 class WS2812FX {  // 96 bytes
   typedef uint16_t (*mode_ptr)(void); // pointer to mode function
@@ -663,6 +847,10 @@ class WS2812FX {  // 96 bytes
       paletteBlend(0),
       milliampsPerLed(55),
       cctBlending(0),
+      frameBudget(0),
+      useSegmentBuffers(false),
+      usePipelining(false),
+      parallelRendering(false),
       ablMilliampsMax(ABL_MILLIAMPS_DEFAULT),
       currentMilliamps(0),
       now(millis()),
@@ -671,27 +859,34 @@ class WS2812FX {  // 96 bytes
 #ifndef WLED_DISABLE_2D
       panels(1),
 #endif
-      // semi-private (just obscured) used in effect functions through macros
-      _currentPalette(CRGBPalette16(CRGB::Black)),
-      _colors_t{0,0,0},
-      _virtualSegmentLength(0),
       // true private variables
       _length(DEFAULT_LED_COUNT),
       _brightness(DEFAULT_BRIGHTNESS),
       _transitionDur(750),
       _targetFps(WLED_FPS),
       _frametime(FRAMETIME_FIXED),
+      _frametimeUs(1000000UL/WLED_FPS),
+      _minShowDelayUs(15000),
       _cumulativeFps(2),
       _isServicing(false),
+      _isRenderingParallel(false),
       _isOffRefreshRequired(false),
       _hasWhiteChannel(false),
       _triggered(false),
       _modeCount(MODE_COUNT),
       _callback(nullptr),
+      _bench(nullptr),
+      _benchReqFrames(0),
+      _benchReqLayouts(0),
+      _benchRequested(false),
       customMappingTable(nullptr),
       customMappingSize(0),
+      _mappingGen(0),
       _lastShow(0),
-      _segment_index(0),
+      _lastShowUs(0),
+      _nextDue(0),
+      _lastGovern(0),
+      _skipIdleRefresh(false),
       _mainSegment(0),
       _queuedChangesSegId(255),
       _qStart(0),
@@ -710,6 +905,7 @@ class WS2812FX {  // 96 bytes
     }
 
     ~WS2812FX() {
+      endBenchmark();
       if (customMappingTable) delete[] customMappingTable;
       _mode.clear();
       _modeData.clear();
@@ -742,8 +938,10 @@ class WS2812FX {  // 96 bytes
       makeAutoSegments(bool forceReset = false),
       fixInvalidSegments(),
       setPixelColor(int n, uint32_t c),
+      setPixelColors(int n, uint16_t count, const uint32_t *c), // sets count consecutive pixels (unmapped runs are passed to busses in bulk)
       show(void),
-      setTargetFps(uint8_t fps);
+      setTargetFps(uint16_t fps),
+      requestBenchmark(uint8_t frames, uint16_t layouts = 0); // frames 0: abort & free results, layouts 0: all; defined in FX_bench.cpp
 
     void setColor(uint8_t slot, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) { setColor(slot, RGBW32(r,g,b,w)); }
     void fill(uint32_t c) { for (int i = 0; i < getLengthTotal(); i++) setPixelColor(i, c); } // fill whole strip with color (inline)
@@ -767,6 +965,9 @@ class WS2812FX {  // 96 bytes
       deserializeMap(uint8_t n=0);
 
     inline bool isServicing(void) { return _isServicing; }
+    inline bool isBenchmarking(void) { return _bench != nullptr && _bench->running; }
+    inline bool isBenchmarkPending(void) { return _benchRequested || isBenchmarking(); } // service() has to be called
+    inline bool isRenderingParallel(void) { return _isRenderingParallel; }
     inline bool hasWhiteChannel(void) {return _hasWhiteChannel;}
     inline bool isOffRefreshRequired(void) {return _isOffRefreshRequired;}
 
@@ -781,15 +982,35 @@ class WS2812FX {  // 96 bytes
       getActiveSegsLightCapabilities(bool selectedOnly = false),
       setPixelSegment(uint8_t n);
 
+    uint8_t
+      frameBudget;       // ms a service() pass (render + show) may take on average, governor lowers frame rate of expensive segments (0 = off)
+
+    bool
+      useSegmentBuffers, // render segments into own framebuffers and composite them in show()
+      usePipelining,     // transmit busses from worker task while next frame is rendered (applied in finalizeInit())
+      parallelRendering; // render segments on WLED_RENDER_WORKERS tasks (requires useSegmentBuffers)
+
+    size_t getSegmentBuffersSize(void);
+    size_t getSegmentMapsSize(void);
+
     inline uint8_t getBrightness(void) { return _brightness; }
     inline uint8_t getMaxSegments(void) { return MAX_NUM_SEGMENTS; }  // returns maximum number of supported segments (fixed value)
     inline uint8_t getSegmentsNum(void) { return _segments.size(); }  // returns currently present segments
-    inline uint8_t getCurrSegmentId(void) { return _segment_index; }
+    inline uint8_t getCurrSegmentId(void) { return _ctx[RENDER_CONTEXT_ID()].segmentIndex; }
+    inline Segment& getCurrSegment(void) { render_context_t &ctx = _ctx[RENDER_CONTEXT_ID()]; return ctx.segment ? *ctx.segment : _segments[ctx.segmentIndex]; }
     inline uint8_t getMainSegmentId(void) { return _mainSegment; }
     inline uint8_t getPaletteCount() { return 13 + GRADIENT_PALETTE_COUNT; }  // will only return built-in palette count
-    inline uint8_t getTargetFps() { return _targetFps; }
+    inline uint16_t getTargetFps() { return _targetFps; }
     inline uint8_t getModeCount() { return _modeCount; }
 
+    // effect benchmark results; defined in FX_bench.cpp
+    uint8_t  getBenchmarkFrames(void);
+    uint8_t  getBenchmarkProgress(void); // percent of requested layouts/effects measured
+    uint16_t getBenchmarkLayouts(void);  // bitmask of requested layouts
+    uint16_t getBenchmarkResult(uint8_t layout, uint8_t mode, bool p99 = false); // mean or 99th percentile frame time (us)
+    static void getBenchmarkLayout(uint8_t layout, uint16_t &width, uint16_t &height, bool &groupMirror);
+    static uint16_t getBenchmarkPixels(uint8_t layout); // virtual pixels effects render in layout
+
     uint16_t
       ablMilliampsMax,
       currentMilliamps,
@@ -797,7 +1018,14 @@ class WS2812FX {  // 96 bytes
       getLengthTotal(void), // will include virtual/nonexistent pixels in matrix
       getFps();
 
+    inline TimingStat &getAblTime(void) { return _ablTime; } // estimateCurrentAndLimitBri() duration (us)
+    inline TimingStat &getPassTime(void) { return _passTime; } // service() pass duration incl. show() (us)
+    inline bool isSkippingIdleRefresh(void) { return _skipIdleRefresh; } // governor: frozen/static segments do not force shows
+    uint32_t getTimeToNextFrame(void); // ms until service() has work to do (0 = now)
     inline uint16_t getFrameTime(void) { return _frametime; }
+    inline uint32_t getFrameTimeUs(void) { return _frametimeUs; }
+    inline TimingStat &getFrameInterval(void) { return _frameInterval; } // us between shows
+    inline TimingStat &getFrameJitter(void)   { return _frameJitter; }   // us deviation of frame interval from target
     inline uint16_t getMinShowDelay(void) { return MIN_SHOW_DELAY; }
     inline uint16_t getLength(void) { return _length; } // 2D matrix may have less pixels than W*H
     inline uint16_t getTransition(void) { return _transitionDur; }
@@ -808,7 +1036,7 @@ class WS2812FX {  // 96 bytes
       getPixelColor(uint16_t);
 
     inline uint32_t getLastShow(void) { return _lastShow; }
-    inline uint32_t segColor(uint8_t i) { return _colors_t[i]; }
+    inline uint32_t segColor(uint8_t i) { return _ctx[RENDER_CONTEXT_ID()].colors[i]; }
 
     const char *
       getModeData(uint8_t id = 0) { return (id && id<_modeCount) ? _modeData[id] : PSTR("Solid"); }
@@ -869,13 +1097,11 @@ class WS2812FX {  // 96 bytes
   // end 2D support
 
     void loadCustomPalettes(void); // loads custom palettes from JSON
-    CRGBPalette16 _currentPalette; // palette used for current effect (includes transition)
     std::vector<CRGBPalette16> customPalettes; // TODO: move custom palettes out of WS2812FX class
 
     // using public variables to reduce code size increase due to inline function getSegment() (with bounds checking)
     // and color transitions
-    uint32_t _colors_t[3]; // color used for effect (includes transition)
-    uint16_t _virtualSegmentLength;
+    render_context_t _ctx[WLED_RENDER_WORKERS]; // context of the segment each render worker is processing
 
     std::vector<segment> _segments;
     friend class Segment;
@@ -885,13 +1111,16 @@ class WS2812FX {  // 96 bytes
     uint8_t  _brightness;
     uint16_t _transitionDur;
 
-    uint8_t  _targetFps;
-    uint16_t _frametime;
+    uint16_t _targetFps;
+    uint16_t _frametime;      // ms, used by effects (FRAMETIME)
+    uint32_t _frametimeUs;    // exact target frame time
+    uint32_t _minShowDelayUs; // min. time between two shows (MIN_SHOW_DELAY or exact frame time in high refresh mode)
     uint16_t _cumulativeFps;
 
     // will require only 1 byte
     struct {
       bool _isServicing          : 1;
+      bool _isRenderingParallel  : 1;
       bool _isOffRefreshRequired : 1; //periodic refresh is required for the strip to remain off.
       bool _hasWhiteChannel      : 1;
       bool _triggered            : 1;
@@ -903,22 +1132,66 @@ class WS2812FX {  // 96 bytes
 
     show_callback _callback;
 
+    // effect benchmark state, allocated on request; user segments are not rendered while it runs
+    struct EffectBenchmark {
+      Segment      *seg;            // detached segment for the layout being measured
+      uint8_t       frames;         // frames per effect and layout
+      uint16_t      layouts;        // requested layouts (bitmask)
+      uint8_t       layout;         // layout being measured
+      uint8_t       mode;           // effect being measured
+      uint8_t       frame;
+      uint16_t      done;           // effects measured so far (all layouts)
+      bool          running;
+      unsigned long start;          // effect time of first frame
+      uint32_t     *samples;        // frame times of current effect (us)
+      uint16_t     *results;        // [requested layout][mode][mean, p99] (us)
+    } *_bench;
+    uint8_t           _benchReqFrames;  // set by requestBenchmark(), consumed by service()
+    uint16_t          _benchReqLayouts;
+    volatile bool     _benchRequested;
+
     uint16_t* customMappingTable;
     uint16_t  customMappingSize;
+    uint8_t   _mappingGen; // incremented whenever logical to physical mapping changes (invalidates segment geometry maps)
 
     unsigned long _lastShow;
+    unsigned long _lastShowUs;
+    TimingStat    _frameInterval;
+    TimingStat    _frameJitter;
+    unsigned long _nextDue; // earliest next_time of active segments (computed at end of each pass)
+    TimingStat    _ablTime;
+    TimingStat    _passTime;
+    unsigned long _lastGovern;
+    bool          _skipIdleRefresh;
 
-    uint8_t _segment_index;
     uint8_t _mainSegment;
     uint8_t _queuedChangesSegId;
     uint16_t _qStart, _qStop, _qStartY, _qStopY;
     uint8_t _qGrouping, _qSpacing;
     uint16_t _qOffset;
 
+  #if WLED_RENDER_WORKERS > 1
+    struct RenderJob {
+      WS2812FX     *strip;
+      uint32_t      segments; // bitmask of segments to render
+      unsigned long nowUs;
+      uint8_t       context;  // render context used by worker (host build)
+    } _renderJob[WLED_RENDER_WORKERS-1];
+    TaskWorker _renderWorker[WLED_RENDER_WORKERS-1];
+
+    void renderParallel(uint32_t segments, unsigned long nowUs);
+    static void renderJob(void *job);
+  #endif
+
     uint8_t
       estimateCurrentAndLimitBri(void);
 
     void
+      governFrameRate(uint32_t passUs),
+      handleBenchmark(void),
+      endBenchmark(bool restoreOnly = false),
+      renderSegment(Segment &seg, render_context_t &ctx, unsigned long nowUs),
+      renderSegments(uint32_t segments, unsigned long nowUs),
       setUpSegmentFromQueuedChanges(void);
 };
 
@@ -40,6 +40,7 @@ void WS2812FX::setUpMatrix() {
   if (customMappingTable != nullptr) delete[] customMappingTable;
   customMappingTable = nullptr;
   customMappingSize = 0;
+  _mappingGen++;
 
   // isMatrix is set in cfg.cpp or set.cpp
   if (isMatrix) {
@@ -199,7 +200,18 @@ void /*IRAM_ATTR*/ Segment::setPixelColorXY(int x, int y, uint32_t col)
   if (!isActive()) return; // not active
   if (x >= virtualWidth() || y >= virtualHeight() || x<0 || y<0) return;  // if pixel would fall out of virtual segment just exit
 
-  uint8_t _bri_t = currentBri(on ? opacity : 0);
+  if (_buf) { // draw into segment framebuffer, composited in WS2812FX::show()
+    size_t idx = x + y * virtualWidth();
+    if (idx < _bufLen) _buf[idx] = col;
+    return;
+  }
+  paintPixelXY(x, y, col);
+}
+
+// writes pixel to physical pixels (taking into account opacity, grouping, reverse, transpose & mirror)
+void /*IRAM_ATTR*/ Segment::paintPixelXY(int x, int y, uint32_t col)
+{
+  uint8_t _bri_t = _opacityT; // updated once per frame
   if (_bri_t < 255) {
     byte r = scale8(R(col), _bri_t);
     byte g = scale8(G(col), _bri_t);
@@ -286,6 +298,10 @@ void Segment::setPixelColorXY(float x, float y, uint32_t col, bool aa)
 uint32_t Segment::getPixelColorXY(uint16_t x, uint16_t y) {
   if (!isActive()) return 0; // not active
   if (x >= virtualWidth() || y >= virtualHeight() || x<0 || y<0) return 0;  // if pixel would fall out of virtual segment just exit
+  if (_buf) { // lossless read from segment framebuffer
+    size_t idx = x + y * virtualWidth();
+    return (idx < _bufLen) ? _buf[idx] : 0;
+  }
   if (reverse  ) x = virtualWidth()  - x - 1;
   if (reverse_y) y = virtualHeight() - y - 1;
   if (transpose) { uint16_t t = x; x = y; y = t; } // swap X & Y if segment transposed
@@ -334,6 +350,10 @@ void Segment::blurRow(uint16_t row, fract8 blur_amount) {
   const uint_fast16_t rows = virtualHeight();
 
   if (row >= rows) return;
+  if (is2D() && spanLength() >= (row+1) * cols) {
+    color_blur_span(_buf + row * cols, cols, 1, blur_amount);
+    return;
+  }
   // blur one row
   uint8_t keep = 255 - blur_amount;
   uint8_t seep = blur_amount >> 1;
@@ -362,6 +382,10 @@ void Segment::blurCol(uint16_t col, fract8 blur_amount) {
   const uint_fast16_t rows = virtualHeight();
 
   if (col >= cols) return;
+  if (is2D() && spanLength() >= rows * cols) {
+    color_blur_span(_buf + col, rows, cols, blur_amount);
+    return;
+  }
   // blur one column
   uint8_t keep = 255 - blur_amount;
   uint8_t seep = blur_amount >> 1;
@@ -534,6 +558,10 @@ void Segment::nscale8(uint8_t scale) {
   if (!isActive()) return; // not active
   const uint16_t cols = virtualWidth();
   const uint16_t rows = virtualHeight();
+  if (is2D() && spanLength() >= rows * cols) {
+    color_scale_span(_buf, rows * cols, 1, scale);
+    return;
+  }
   for(uint16_t y = 0; y < rows; y++) for (uint16_t x = 0; x < cols; x++) {
     setPixelColorXY(x, y, CRGB(getPixelColorXY(x, y)).nscale8(scale));
   }
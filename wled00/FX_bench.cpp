@@ -0,0 +1,226 @@
+/*
+  FX_bench.cpp contains the effect benchmark
+
+  Runs every registered effect for a number of frames on a set of standard layouts and records
+  mean and 99th percentile frame times. Effects render into the framebuffer of a detached segment
+  held by the benchmark (nothing is sent to LEDs), user segments stay in place and may be edited
+  while it runs but are not rendered. Time is sliced so the main loop (network, web UI) keeps running.
+  The benchmark advances from service(), which is also called while the strip is off.
+
+  Request: {"bench":{"n":<frames>,"l":<layout bitmask>}} via JSON API, results: /json/bench[?l=<layout>]
+
+  LICENSE
+  The MIT License (MIT)
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+#include <algorithm>
+#include "wled.h"
+#include "FX.h"
+
+#define BENCH_SLICE_MS 15 // max. time spent rendering per service() call
+
+// even layouts are plain, odd ones use grouping 2 and mirror (mirror_y for 2D)
+static const uint16_t benchSize[BENCH_LAYOUT_COUNT/2][2] = {
+  {  300,  1 }, { 1500,  1 }, { 5000,  1 },
+  {   16, 16 }, {   32, 32 }, {   64, 64 }
+};
+
+static uint8_t countBits(uint16_t v) {
+  uint8_t n = 0;
+  for (; v; v &= v - 1) n++;
+  return n;
+}
+
+void WS2812FX::getBenchmarkLayout(uint8_t layout, uint16_t &width, uint16_t &height, bool &groupMirror) {
+  if (layout >= BENCH_LAYOUT_COUNT) layout = 0;
+  width       = benchSize[layout>>1][0];
+  height      = benchSize[layout>>1][1];
+  groupMirror = layout & 0x01;
+}
+
+uint16_t WS2812FX::getBenchmarkPixels(uint8_t layout) {
+  uint16_t w, h;
+  bool gm;
+  getBenchmarkLayout(layout, w, h, gm);
+  if (gm) {
+    w = ((w + 1) / 2 + 1) / 2; // grouping 2, mirror
+    if (h > 1) h = ((h + 1) / 2 + 1) / 2;
+  }
+  return w * h;
+}
+
+// may be called from async web server, benchmark is started/stopped from service()
+void WS2812FX::requestBenchmark(uint8_t frames, uint16_t layouts) {
+  layouts &= (1U << BENCH_LAYOUT_COUNT) - 1;
+  _benchReqFrames  = MIN(frames, BENCH_MAX_FRAMES);
+  _benchReqLayouts = layouts ? layouts : (1U << BENCH_LAYOUT_COUNT) - 1;
+  _benchRequested  = true;
+}
+
+uint8_t WS2812FX::getBenchmarkFrames() {
+  return _bench ? _bench->frames : 0;
+}
+
+uint16_t WS2812FX::getBenchmarkLayouts() {
+  return _bench ? _bench->layouts : 0;
+}
+
+uint8_t WS2812FX::getBenchmarkProgress() {
+  if (!_bench) return 0;
+  if (!_bench->running) return 100;
+  return (100UL * _bench->done) / (countBits(_bench->layouts) * _modeCount);
+}
+
+uint16_t WS2812FX::getBenchmarkResult(uint8_t layout, uint8_t mode, bool p99) {
+  if (!_bench || !_bench->results || layout >= BENCH_LAYOUT_COUNT || mode >= _modeCount) return BENCH_NO_RESULT;
+  if (!(_bench->layouts & (1U << layout))) return BENCH_NO_RESULT;
+  size_t rank = countBits(_bench->layouts & ((1U << layout) - 1)); // results are only kept for requested layouts
+  return _bench->results[(rank * _modeCount + mode) * 2 + p99];
+}
+
+// stops benchmark (user segments are rendered again); unless restoreOnly also frees benchmark results
+void WS2812FX::endBenchmark(bool restoreOnly) {
+  if (!_bench) return;
+  delete _bench->seg;
+  _bench->seg = nullptr;
+  _bench->running = false;
+  free(_bench->samples);
+  _bench->samples = nullptr;
+  if (restoreOnly) return;
+  free(_bench->results);
+  delete _bench;
+  _bench = nullptr;
+}
+
+/*
+ * Called from service() while a benchmark is requested or running, instead of rendering user segments.
+ */
+void WS2812FX::handleBenchmark() {
+  if (_benchRequested) {
+    _benchRequested = false;
+    endBenchmark();
+    if (!_benchReqFrames) return; // abort only
+    _bench = new EffectBenchmark();
+    if (!_bench) return;
+    _bench->frames  = _benchReqFrames;
+    _bench->layouts = _benchReqLayouts;
+    _bench->layout  = 0;
+    _bench->mode    = 0;
+    _bench->frame   = 0;
+    _bench->done    = 0;
+    _bench->start   = now;
+    _bench->seg     = nullptr;
+    size_t resultsLen = countBits(_bench->layouts) * _modeCount * 2;
+    _bench->samples = (uint32_t*) malloc(_bench->frames * sizeof(uint32_t));
+    _bench->results = (uint16_t*) malloc(resultsLen * sizeof(uint16_t));
+    if (!_bench->samples || !_bench->results) {
+      DEBUG_PRINTLN(F("Benchmark: not enough memory."));
+      endBenchmark();
+      return;
+    }
+    for (size_t i = 0; i < resultsLen; i++) _bench->results[i] = BENCH_NO_RESULT;
+    _bench->running = true;
+    DEBUG_PRINTF("Benchmark: %d frames, layouts 0x%03X\n", (int)_bench->frames, (unsigned)_bench->layouts);
+    return;
+  }
+
+  EffectBenchmark &b = *_bench;
+  render_context_t &ctx = _ctx[RENDER_CONTEXT_ID()];
+  unsigned long sliceStart = millis();
+  _isServicing = true;
+  ctx.segmentIndex = 0;
+  while (millis() - sliceStart < BENCH_SLICE_MS) {
+    if (b.layout >= BENCH_LAYOUT_COUNT) {
+      DEBUG_PRINTLN(F("Benchmark: done."));
+      endBenchmark(true);
+      break;
+    }
+    if (!(b.layouts & (1U << b.layout))) {
+      b.layout++;
+      continue;
+    }
+
+    // set up detached segment for the layout (framebuffer is required so nothing is painted to busses)
+    if (!b.seg) {
+      uint16_t w, h;
+      bool gm;
+      getBenchmarkLayout(b.layout, w, h, gm);
+      bool usable = true;
+      #ifdef WLED_DISABLE_2D
+      if (h > 1) usable = false;
+      #else
+      if (h > 1 && !isMatrix) usable = false; // 2D effects would only render Solid
+      #endif
+      if (usable) {
+        b.seg = new Segment(0, w, 0, h);
+        if (b.seg && gm) {
+          b.seg->grouping = 2;
+          b.seg->mirror   = true;
+          b.seg->mirror_y = h > 1;
+        }
+        usable = b.seg && b.seg->allocateBuffer();
+      }
+      if (!usable) {
+        DEBUG_PRINTF("Benchmark: layout %d skipped.\n", (int)b.layout);
+        delete b.seg;
+        b.seg = nullptr;
+        b.done += _modeCount;
+        b.layout++;
+        continue;
+      }
+      b.mode  = 0;
+      b.frame = 0;
+    }
+
+    Segment &seg = *b.seg;
+    if (b.frame == 0) {
+      if (b.mode && !strncmp_P("RSVD", getModeData(b.mode), 4)) b.frame = b.frames; // reserved slot, no result
+      else {
+        seg.setMode(b.mode, true); // effect defaults (speed, intensity, palette, ...)
+        seg.startTransition(0);    // no fading from previous effect
+        seg.markForReset();
+        seg.resetIfRequired();
+        b.start = millis() + timebase;
+      }
+    }
+    if (b.frame < b.frames) {
+      now = b.start + b.frame * _frametime; // effects see a steady frame rate regardless of how long rendering takes
+      uint32_t t0 = micros();
+      renderSegment(seg, ctx, micros());
+      b.samples[b.frame++] = micros() - t0;
+      if (b.frame < b.frames) continue;
+
+      uint32_t sum = 0;
+      for (size_t i = 0; i < b.frames; i++) sum += b.samples[i];
+      size_t k = (b.frames * 99 + 99) / 100 - 1;
+      std::nth_element(b.samples, b.samples + k, b.samples + b.frames);
+      size_t idx = (countBits(b.layouts & ((1U << b.layout) - 1)) * _modeCount + b.mode) * 2;
+      b.results[idx]   = MIN(sum / b.frames, BENCH_NO_RESULT - 1);
+      b.results[idx+1] = MIN(b.samples[k],   BENCH_NO_RESULT - 1);
+    }
+
+    b.frame = 0;
+    b.done++;
+    if (++b.mode >= _modeCount) {
+      delete b.seg; // next layout
+      b.seg = nullptr;
+      b.layout++;
+    }
+  }
+  ctx.virtualLength = 0;
+  _isServicing = false;
+}
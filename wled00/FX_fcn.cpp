@@ -74,6 +74,14 @@
 // Segment class implementation
 ///////////////////////////////////////////////////////////////////////////////
 uint16_t Segment::_usedSegmentData = 0U; // amount of RAM all segments use for their data[]
+volatile bool Segment::_resetPending = false;
+#ifdef WLED_ENABLE_SEGMENT_ARENA
+SegmentArena Segment::_arena;
+#endif
+#if WLED_RENDER_WORKERS > 1
+TaskMutex Segment::_dataLock;
+thread_local uint8_t renderContextId = 0; // main loop uses context 0
+#endif
 uint16_t Segment::maxWidth = DEFAULT_LED_COUNT;
 uint16_t Segment::maxHeight = 1;
 
@@ -90,6 +98,12 @@ Segment::Segment(const Segment &orig) {
   data = nullptr;
   _dataLen = 0;
   _t = nullptr;
+  _buf = nullptr; // framebuffer is allocated in WS2812FX::service()
+  _bufLen = 0;
+  _map = nullptr; // geometry map is built in WS2812FX::service()
+  #ifdef WLED_ENABLE_PALETTE_CACHE
+  _pc = nullptr; // will be rebuilt on first use
+  #endif
   if (orig.name) { name = new char[strlen(orig.name)+1]; if (name) strcpy(name, orig.name); }
   if (orig.data) { if (allocateData(orig._dataLen)) memcpy(data, orig.data, orig._dataLen); }
   //if (orig._t)   { _t = new Transition(orig._t->_dur, orig._t->_briT, orig._t->_cctT, orig._t->_colorT); }
@@ -100,10 +114,19 @@ Segment::Segment(Segment &&orig) noexcept {
   //DEBUG_PRINTLN(F("-- Move segment constructor --"));
   memcpy((void*)this, (void*)&orig, sizeof(Segment));
   orig.transitional = false; // old segment cannot be in transition any more
+  #ifdef WLED_ENABLE_SEGMENT_ARENA
+  if (data) _arena.setOwner(data, this);
+  #endif
   orig.name = nullptr;
   orig.data = nullptr;
   orig._dataLen = 0;
   orig._t   = nullptr;
+  orig._buf = nullptr;
+  orig._bufLen = 0;
+  orig._map = nullptr;
+  #ifdef WLED_ENABLE_PALETTE_CACHE
+  orig._pc  = nullptr;
+  #endif
 }
 
 // copy assignment
@@ -114,7 +137,12 @@ Segment& Segment::operator= (const Segment &orig) {
     transitional = false; // copied segment cannot be in transition
     if (name) delete[] name;
     if (_t)   delete _t;
+    #ifdef WLED_ENABLE_PALETTE_CACHE
+    if (_pc)  delete _pc;
+    #endif
     deallocateData();
+    deallocateBuffer();
+    deallocateGeometryMap();
     // copy source
     memcpy((void*)this, (void*)&orig, sizeof(Segment));
     transitional = false;
@@ -123,6 +151,12 @@ Segment& Segment::operator= (const Segment &orig) {
     data = nullptr;
     _dataLen = 0;
     _t = nullptr;
+    _buf = nullptr;
+    _bufLen = 0;
+    _map = nullptr;
+    #ifdef WLED_ENABLE_PALETTE_CACHE
+    _pc = nullptr;
+    #endif
     // copy source data
     if (orig.name) { name = new char[strlen(orig.name)+1]; if (name) strcpy(name, orig.name); }
     if (orig.data) { if (allocateData(orig._dataLen)) memcpy(data, orig.data, orig._dataLen); }
@@ -138,23 +172,45 @@ Segment& Segment::operator= (Segment &&orig) noexcept {
     transitional = false; // just temporary
     if (name) { delete[] name; name = nullptr; } // free old name
     deallocateData(); // free old runtime data
+    deallocateBuffer();
+    deallocateGeometryMap();
     if (_t) { delete _t; _t = nullptr; }
+    #ifdef WLED_ENABLE_PALETTE_CACHE
+    if (_pc) { delete _pc; _pc = nullptr; }
+    #endif
     memcpy((void*)this, (void*)&orig, sizeof(Segment));
     orig.transitional = false; // old segment cannot be in transition
+    #ifdef WLED_ENABLE_SEGMENT_ARENA
+    if (data) _arena.setOwner(data, this);
+    #endif
     orig.name = nullptr;
     orig.data = nullptr;
     orig._dataLen = 0;
     orig._t   = nullptr;
+    orig._buf = nullptr;
+    orig._bufLen = 0;
+    orig._map = nullptr;
+    #ifdef WLED_ENABLE_PALETTE_CACHE
+    orig._pc  = nullptr;
+    #endif
   }
   return *this;
 }
 
 bool Segment::allocateData(size_t len) {
   if (data && _dataLen == len) return true; //already allocated
+  #if WLED_RENDER_WORKERS > 1
+  TaskLock lock(_dataLock); // _usedSegmentData (and arena) are shared by all render workers
+  #endif
   deallocateData();
   if (Segment::getUsedSegmentData() + len > MAX_SEGMENT_DATA) return false; //not enough memory
+  #ifdef WLED_ENABLE_SEGMENT_ARENA
+  // only relocate other segments' data while effects are run from the main loop (and no other worker is rendering)
+  data = _arena.alloc(len, this, strip.isServicing() && !strip.isRenderingParallel());
+  #else
   // do not use SPI RAM on ESP32 since it is slow
   data = (byte*) malloc(len);
+  #endif
   if (!data) return false; //allocation failed
   Segment::addUsedSegmentData(len);
   _dataLen = len;
@@ -164,12 +220,189 @@ bool Segment::allocateData(size_t len) {
 
 void Segment::deallocateData() {
   if (!data) return;
+  #if WLED_RENDER_WORKERS > 1
+  TaskLock lock(_dataLock);
+  #endif
+  #ifdef WLED_ENABLE_SEGMENT_ARENA
+  _arena.free(data);
+  #else
   free(data);
+  #endif
   data = nullptr;
   Segment::addUsedSegmentData(-_dataLen);
   _dataLen = 0;
 }
 
+#ifdef WLED_ENABLE_SEGMENT_ARENA
+///////////////////////////////////////////////////////////////////////////////
+// Segment data arena
+///////////////////////////////////////////////////////////////////////////////
+
+uint8_t *SegmentArena::alloc(size_t len, Segment *owner, bool canCompact) {
+  size_t size = (len + ALIGN - 1) & ~(ALIGN - 1);
+  if (!size || size > UINT16_MAX) return nullptr;
+  // first fit into a gap left by freed data
+  for (size_t pos = 0; pos < _top; ) {
+    Block *b = (Block*)(_mem + pos);
+    if (!b->owner && b->size >= size) {
+      if (b->size >= size + HDR + ALIGN) { // split, remainder stays free
+        Block *r = (Block*)(_mem + pos + HDR + size);
+        r->size  = b->size - size - HDR;
+        r->owner = nullptr;
+        b->size  = size;
+      }
+      b->owner = owner;
+      return _mem + pos + HDR;
+    }
+    pos += HDR + b->size;
+  }
+  // append at the end, compact if there is enough space but it is fragmented
+  if (_top + HDR + size > sizeof(_mem)) {
+    if (!canCompact || getFree() < HDR + size) return nullptr;
+    compact();
+    if (_top + HDR + size > sizeof(_mem)) return nullptr;
+  }
+  Block *b = (Block*)(_mem + _top);
+  b->size  = size;
+  b->owner = owner;
+  _top += HDR + size;
+  return (uint8_t*)b + HDR;
+}
+
+void SegmentArena::free(uint8_t *p) {
+  if (p < _mem + HDR || p >= _mem + _top) return; // not from arena
+  ((Block*)(p - HDR))->owner = nullptr;
+  coalesce();
+}
+
+void SegmentArena::setOwner(uint8_t *p, Segment *owner) {
+  if (p < _mem + HDR || p >= _mem + _top) return;
+  ((Block*)(p - HDR))->owner = owner;
+}
+
+void SegmentArena::coalesce() {
+  size_t end = 0; // end of last used block
+  for (size_t pos = 0; pos < _top; ) {
+    Block *b = (Block*)(_mem + pos);
+    if (!b->owner) {
+      // absorb following free blocks
+      size_t next = pos + HDR + b->size;
+      while (next < _top && !((Block*)(_mem + next))->owner) {
+        size_t merged = b->size + HDR + ((Block*)(_mem + next))->size;
+        if (merged > UINT16_MAX) break;
+        b->size = merged;
+        next = pos + HDR + b->size;
+      }
+    } else {
+      end = pos + HDR + b->size;
+    }
+    pos += HDR + b->size;
+  }
+  _top = end; // trailing free blocks are returned to the unallocated end
+}
+
+void SegmentArena::compact() {
+  size_t dst = 0;
+  for (size_t pos = 0; pos < _top; ) {
+    Block *b = (Block*)(_mem + pos);
+    size_t blockLen = HDR + b->size;
+    Segment *owner = b->owner;
+    if (owner) {
+      if (dst != pos) {
+        memmove(_mem + dst, _mem + pos, blockLen);
+        owner->data = _mem + dst + HDR;
+      }
+      dst += blockLen;
+    }
+    pos += blockLen;
+  }
+  _top = dst;
+  _compactions++;
+}
+
+size_t SegmentArena::getFree() const {
+  size_t freeBytes = sizeof(_mem) - _top;
+  for (size_t pos = 0; pos < _top; ) {
+    const Block *b = (const Block*)(_mem + pos);
+    if (!b->owner) freeBytes += HDR + b->size;
+    pos += HDR + b->size;
+  }
+  return freeBytes;
+}
+
+size_t SegmentArena::getLargestFree() const {
+  size_t largest = sizeof(_mem) - _top;
+  for (size_t pos = 0; pos < _top; ) {
+    const Block *b = (const Block*)(_mem + pos);
+    if (!b->owner && HDR + b->size > largest) largest = HDR + b->size;
+    pos += HDR + b->size;
+  }
+  return largest;
+}
+
+uint8_t SegmentArena::getFragmentation() const {
+  size_t freeBytes = getFree();
+  return freeBytes ? 100 - (getLargestFree() * 100) / freeBytes : 0;
+}
+#endif
+
+/*
+ * Segment framebuffer holds one RGBW value per virtual pixel (virtualWidth() x virtualHeight() for segments
+ * using 2D mapping, virtualLength() otherwise). Effects draw into it and WS2812FX::show() composites all
+ * framebuffers into physical pixels once per frame.
+ * Only (re)allocate or free it from the main loop (WS2812FX::service()) as effects may be using it.
+ */
+bool Segment::allocateBuffer() {
+  uint16_t len = usesMatrix() ? virtualWidth() * virtualHeight() : virtualLength();
+  if (_buf && _bufLen == len) return true; // already allocated
+  deallocateBuffer();
+  if (!len) return false;
+  // do not use SPI RAM on ESP32 since it is slow
+  _buf = (uint32_t*) malloc(len * sizeof(uint32_t));
+  if (!_buf) return false; // allocation failed, segment will paint physical pixels directly
+  memset(_buf, 0, len * sizeof(uint32_t));
+  _bufLen = len;
+  return true;
+}
+
+void Segment::deallocateBuffer() {
+  if (!_buf) return;
+  free(_buf);
+  _buf = nullptr;
+  _bufLen = 0;
+}
+
+/*
+ * Writes framebuffer content (or black if clear is set) to physical pixels applying
+ * opacity, grouping, spacing, offset, reverse & mirror. Clearing also works without framebuffer.
+ */
+void Segment::drawBuffer(bool clear) {
+  if (!isActive() || (!clear && !_buf)) return;
+  refreshOpacity();
+  if (usesMatrix()) {
+    const uint16_t cols = virtualWidth();
+    const uint16_t rows = virtualHeight();
+    for (uint16_t y = 0; y < rows; y++) for (uint16_t x = 0; x < cols; x++) {
+      size_t idx = x + y * cols;
+      if (clear)              paintPixelXY(x, y, BLACK);
+      else if (idx < _bufLen) paintPixelXY(x, y, _buf[idx]);
+    }
+  } else {
+    const uint16_t len = clear ? virtualLength() : MIN(virtualLength(), _bufLen);
+    for (uint16_t i = 0; i < len; i++) paintPixel(i, clear ? BLACK : _buf[i]);
+  }
+}
+
+/*
+ * Framebuffer can be processed as a contiguous span (with SWAR kernels from colors.cpp) if virtual pixel
+ * index equals buffer index, which is not the case for 1D segments expanded into matrix.
+ */
+size_t Segment::spanLength() const {
+  if (!_buf) return 0;
+  size_t len = is2D() ? virtualWidth() * virtualHeight() : (usesMatrix() ? 0 : virtualLength());
+  return len < _bufLen ? len : _bufLen;
+}
+
 /**
   * If reset of this segment was requested, clears runtime
   * settings of this segment.
@@ -332,6 +565,26 @@ CRGBPalette16 &Segment::currentPalette(CRGBPalette16 &targetPalette, uint8_t pal
   return targetPalette;
 }
 
+/*
+ * Expands given palette into 256 entry table used by color_from_palette().
+ * Table is only rebuilt if palette (including transition blending) or global blending changed.
+ * Called once per frame from WS2812FX::service() with the palette the effect is about to use,
+ * table is created on first use in color_from_palette().
+ */
+void Segment::updatePaletteCache(const CRGBPalette16 &pal, bool create) {
+#ifdef WLED_ENABLE_PALETTE_CACHE
+  TBlendType blendType = (strip.paletteBlend == 3) ? NOBLEND : LINEARBLEND;
+  if (!_pc) {
+    if (!create) return; // segment's effect does not use color_from_palette()
+    _pc = new PaletteCache;
+    if (!_pc) return; // allocation failed, color_from_palette() will decode palette itself
+  } else if (_pc->_blendType == blendType && _pc->_src == pal) return; // up to date
+  _pc->_src = pal;
+  _pc->_blendType = blendType;
+  for (int i = 0; i < 256; i++) _pc->_lut[i] = ColorFromPalette(pal, i, 255, blendType);
+#endif
+}
+
 void Segment::handleTransition() {
   if (!transitional) return;
   uint16_t _progress = progress();
@@ -348,6 +601,9 @@ void Segment::handleTransition() {
 void Segment::handleRandomPalette() {
   // just do a blend; if the palettes are identical it will just compare 48 bytes (same as _randomPalette == _newRandomPalette)
   // this will slowly blend _newRandomPalette into _randomPalette every 15ms or 8ms (depending on MIN_SHOW_DELAY)
+  static unsigned long lastBlend = 0;
+  if (millis() - lastBlend < 8) return; // keep blending speed independent of high refresh rates
+  lastBlend = millis();
   nblendPaletteTowardPalette(_randomPalette, _newRandomPalette, 48);
 }
 
@@ -362,7 +618,7 @@ void Segment::setUp(uint16_t i1, uint16_t i2, uint8_t grp, uint8_t spc, uint16_t
       && (!grp || (grouping == grp && spacing == spc))
       && (ofs == UINT16_MAX || ofs == offset)) return;
 
-  if (stop) fill(BLACK); // turn old segment range off (clears pixels if changing spacing)
+  if (stop) drawBuffer(true); // turn old segment range off (clears pixels if changing spacing)
   if (grp) { // prevent assignment of 0
     grouping = grp;
     spacing = spc;
@@ -427,6 +683,7 @@ void Segment::setOpacity(uint8_t o) {
   if (opacity == o) return;
   if (fadeTransition) startTransition(strip.getTransition()); // start transition prior to change
   opacity = o;
+  refreshOpacity();
   stateChanged = true; // send UDP/WS broadcast
 }
 
@@ -435,6 +692,7 @@ void Segment::setOption(uint8_t n, bool val) {
   if (fadeTransition && n == SEG_OPTION_ON && val != prevOn) startTransition(strip.getTransition()); // start transition prior to change
   if (val) options |=   0x01 << n;
   else     options &= ~(0x01 << n);
+  if (n == SEG_OPTION_ON) refreshOpacity();
   if (!(n == SEG_OPTION_SELECTED || n == SEG_OPTION_RESET || n == SEG_OPTION_TRANSITIONAL)) stateChanged = true; // send UDP/WS broadcast
 }
 
@@ -444,6 +702,8 @@ void Segment::setMode(uint8_t fx, bool loadDefaults) {
     if (fx != mode) {
       if (fadeTransition) startTransition(strip.getTransition()); // set effect transitions
       mode = fx;
+      _fxTime.reset(); // timing statistics are per effect
+      _throttle = 0;
 
       // load default values from effect string
       if (loadDefaults) {
@@ -604,16 +864,31 @@ void IRAM_ATTR Segment::setPixelColor(int i, uint32_t col)
   }
 #endif
 
-  uint16_t len = length();
-  uint8_t _bri_t = currentBri(on ? opacity : 0);
-  if (_bri_t < 255) {
-    byte r = scale8(R(col), _bri_t);
-    byte g = scale8(G(col), _bri_t);
-    byte b = scale8(B(col), _bri_t);
-    byte w = scale8(W(col), _bri_t);
+  if (_buf) { // draw into segment framebuffer, composited in WS2812FX::show()
+    if (i < _bufLen) _buf[i] = col;
+    return;
+  }
+  paintPixel(i, col);
+}
+
+// writes pixel of a 1D segment to physical pixels (taking into account opacity, grouping, spacing, offset, reverse & mirror)
+void IRAM_ATTR Segment::paintPixel(int i, uint32_t col)
+{
+  if (_opacityT < 255) {
+    byte r = scale8(R(col), _opacityT);
+    byte g = scale8(G(col), _opacityT);
+    byte b = scale8(B(col), _opacityT);
+    byte w = scale8(W(col), _opacityT);
     col = RGBW32(r, g, b, w);
   }
 
+  if (_map && i < _map->vLen) { // precomputed geometry
+    const uint16_t *idx = (const uint16_t*)(_map + 1) + i * _map->stride;
+    for (unsigned j = 0; j < _map->stride; j++) if (idx[j] != 0xFFFFU) busses.setPixelColor(idx[j], col);
+    return;
+  }
+
+  uint16_t len = length();
   // expand pixel (taking into account start, grouping, spacing [and offset])
   i = i * groupLength();
   if (reverse) { // is segment reversed?
@@ -642,6 +917,74 @@ void IRAM_ATTR Segment::setPixelColor(int i, uint32_t col)
   }
 }
 
+void Segment::deallocateGeometryMap() {
+  if (!_map) return;
+  free(_map);
+  _map = nullptr;
+}
+
+/*
+ * Precomputes physical (bus) pixel indices of each virtual pixel of a 1D segment using the same
+ * expansion as paintPixel() (grouping, spacing, reverse, mirror, offset) followed by ledmap translation.
+ * Called every frame from WS2812FX::service(), only rebuilds if geometry changed (bounds and grouping
+ * change in setUp(), reverse/mirror in setOption() or directly from JSON/UDP, ledmap or busses in strip).
+ * 2D segments are not mapped. On ESP8266 the map is only built if there is enough free heap.
+ */
+void Segment::updateGeometryMap() {
+  if (!isActive() || usesMatrix()) { deallocateGeometryMap(); return; }
+  uint8_t flags = reverse | (mirror << 1);
+  if (_map && _map->start == start && _map->stop == stop && _map->offset == offset && _map->grouping == grouping
+      && _map->spacing == spacing && _map->flags == flags && _map->gen == strip._mappingGen) return; // up to date
+  deallocateGeometryMap();
+
+  uint16_t vLen   = virtualLength();
+  uint16_t stride = grouping * (mirror ? 2 : 1);
+  size_t   size   = sizeof(GeometryMap) + vLen * stride * sizeof(uint16_t);
+  #ifdef ESP8266
+  if (ESP.getFreeHeap() < size + 8192) return; // keep calculating pixel positions on the fly
+  #endif
+  _map = (GeometryMap*) malloc(size);
+  if (!_map) return;
+  _map->start    = start;
+  _map->stop     = stop;
+  _map->offset   = offset;
+  _map->grouping = grouping;
+  _map->spacing  = spacing;
+  _map->flags    = flags;
+  _map->gen      = strip._mappingGen;
+  _map->vLen     = vLen;
+  _map->stride   = stride;
+
+  uint16_t *idx = (uint16_t*)(_map + 1);
+  uint16_t len = length();
+  for (int v = 0; v < vLen; v++, idx += stride) {
+    int i = v * groupLength();
+    if (reverse) i = mirror ? (len - 1) / 2 - i : (len - 1) - i;
+    i += start;
+    for (int j = 0; j < grouping; j++) {
+      uint16_t indexSet = i + ((reverse) ? -j : j);
+      uint16_t indexMir = 0xFFFFU;
+      if (indexSet >= start && indexSet < stop) {
+        if (mirror) {
+          indexMir = stop - indexSet + start - 1;
+          indexMir += offset; // offset/phase
+          if (indexMir >= stop) indexMir -= len; // wrap
+          if (indexMir < strip.customMappingSize) indexMir = strip.customMappingTable[indexMir];
+          if (indexMir >= strip._length) indexMir = 0xFFFFU;
+        }
+        indexSet += offset; // offset/phase
+        if (indexSet >= stop) indexSet -= len; // wrap
+        if (indexSet < strip.customMappingSize) indexSet = strip.customMappingTable[indexSet];
+        if (indexSet >= strip._length) indexSet = 0xFFFFU;
+      } else {
+        indexSet = 0xFFFFU;
+      }
+      if (mirror) { idx[2*j] = indexMir; idx[2*j+1] = indexSet; }
+      else          idx[j] = indexSet;
+    }
+  }
+}
+
 // anti-aliased normalized version of setPixelColor()
 void Segment::setPixelColor(float i, uint32_t col, bool aa)
 {
@@ -705,6 +1048,8 @@ uint32_t Segment::getPixelColor(int i)
   }
 #endif
 
+  if (_buf) return (i < _bufLen) ? _buf[i] : 0; // lossless read from segment framebuffer
+
   if (reverse) i = virtualLength() - i - 1;
   i *= groupLength();
   i += start;
@@ -795,6 +1140,11 @@ void Segment::refreshLightCapabilities() {
  */
 void Segment::fill(uint32_t c) {
   if (!isActive()) return; // not active
+  size_t len = spanLength();
+  if (len) {
+    color_fill_span(_buf, len, c);
+    return;
+  }
   const uint16_t cols = is2D() ? virtualWidth() : virtualLength();
   const uint16_t rows = virtualHeight(); // will be 1 for 1D
   for(uint16_t y = 0; y < rows; y++) for (uint16_t x = 0; x < cols; x++) {
@@ -851,8 +1201,11 @@ void Segment::fade_out(uint8_t rate) {
   int g2 = G(color);
   int b2 = B(color);
 
+  const size_t len = spanLength(); // process framebuffer directly if possible
   for (uint16_t y = 0; y < rows; y++) for (uint16_t x = 0; x < cols; x++) {
-    color = is2D() ? getPixelColorXY(x, y) : getPixelColor(x);
+    const size_t idx = x + y * cols;
+    if (len && idx >= len) return;
+    color = len ? _buf[idx] : is2D() ? getPixelColorXY(x, y) : getPixelColor(x);
     int w1 = W(color);
     int r1 = R(color);
     int g1 = G(color);
@@ -869,14 +1222,20 @@ void Segment::fade_out(uint8_t rate) {
     gdelta += (g2 == g1) ? 0 : (g2 > g1) ? 1 : -1;
     bdelta += (b2 == b1) ? 0 : (b2 > b1) ? 1 : -1;
 
-    if (is2D()) setPixelColorXY(x, y, r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
-    else        setPixelColor(x, r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
+    if (len)         _buf[idx] = RGBW32(r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
+    else if (is2D()) setPixelColorXY(x, y, r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
+    else             setPixelColor(x, r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
   }
 }
 
 // fades all pixels to black using nscale8()
 void Segment::fadeToBlackBy(uint8_t fadeBy) {
   if (!isActive() || fadeBy == 0) return;   // optimization - no scaling to apply
+  size_t len = spanLength();
+  if (len) {
+    color_scale_span(_buf, len, 1, 255-fadeBy);
+    return;
+  }
   const uint16_t cols = is2D() ? virtualWidth() : virtualLength();
   const uint16_t rows = virtualHeight(); // will be 1 for 1D
 
@@ -902,6 +1261,11 @@ void Segment::blur(uint8_t blur_amount)
     return;
   }
 #endif
+  size_t len = spanLength();
+  if (len) {
+    color_blur_span(_buf, len, 1, blur_amount);
+    return;
+  }
   uint8_t keep = 255 - blur_amount;
   uint8_t seep = blur_amount >> 1;
   CRGB carryover = CRGB::Black;
@@ -963,7 +1327,7 @@ uint8_t Segment::get_random_wheel_index(uint8_t pos) {
 
 /*
  * Gets a single color from the currently selected palette.
- * @param i Palette Index (if mapping is true, the full palette will be _virtualSegmentLength long, if false, 255). Will wrap around automatically.
+ * @param i Palette Index (if mapping is true, the full palette will be SEGLEN long, if false, 255). Will wrap around automatically.
  * @param mapping if true, LED position in segment is considered for color
  * @param wrap FastLED palettes will usually wrap back to the start smoothly. Set false to get a hard edge
  * @param mcol If the default palette 0 is selected, return the standard color 0, 1 or 2 instead. If >2, Party palette is used instead
@@ -984,6 +1348,28 @@ uint32_t Segment::color_from_palette(uint16_t i, bool mapping, bool wrap, uint8_
   if (mapping && virtualLength() > 1) paletteIndex = (i*255)/(virtualLength() -1);
   if (!wrap) paletteIndex = scale8(paletteIndex, 240); //cut off blend at palette "end"
   CRGB fastled_col;
+#ifdef WLED_ENABLE_PALETTE_CACHE
+  if (!_pc) { // first use: expand palette (later updated once per frame in WS2812FX::service())
+    CRGBPalette16 curPal;
+    if (transitional && _t) curPal = _t->_palT;
+    else                    loadPalette(curPal, palette);
+    updatePaletteCache(curPal, true);
+  }
+  if (_pc) {
+    fastled_col = _pc->_lut[paletteIndex];
+    if (pbri < 255) { // same brightness scaling as ColorFromPalette()
+      if (pbri) {
+        uint8_t bri = pbri + 1;
+        if (fastled_col.r) fastled_col.r = scale8(fastled_col.r, bri);
+        if (fastled_col.g) fastled_col.g = scale8(fastled_col.g, bri);
+        if (fastled_col.b) fastled_col.b = scale8(fastled_col.b, bri);
+      } else {
+        fastled_col = CRGB::Black;
+      }
+    }
+    return RGBW32(fastled_col.r, fastled_col.g, fastled_col.b, 0);
+  }
+#endif
   CRGBPalette16 curPal;
   if (transitional && _t) curPal = _t->_palT;
   else                    loadPalette(curPal, palette);
@@ -1050,6 +1436,9 @@ void WS2812FX::finalizeInit(void)
     if (pins[0] == 3) bd->reinit();
     #endif
   }
+  busses.buildRouting(); // pixel to bus lookup table
+  busses.setPipelining(usePipelining);
+  _mappingGen++;
 
   if (isMatrix) setUpMatrix();
   else {
@@ -1064,55 +1453,72 @@ void WS2812FX::finalizeInit(void)
   deserializeMap();     // (re)load default ledmap
 }
 
+// segment deadlines are in micros() which rolls over every ~71 minutes, hence signed differences; 0 means due now
+static inline bool isDue(unsigned long nowUs, unsigned long deadline) {
+  return !deadline || (long)(nowUs - deadline) >= 0;
+}
+
 void WS2812FX::service() {
   unsigned long nowUp = millis(); // Be aware, millis() rolls over every 49 days
+  unsigned long nowUs = micros(); // frame scheduling
   now = nowUp + timebase;
-  if (nowUp - _lastShow < MIN_SHOW_DELAY) return;
+  if (isBenchmarkPending()) {
+    handleBenchmark(); // user segments are not rendered while effects are benchmarked (LEDs keep last frame)
+    return;
+  }
+  if (nowUs - _lastShowUs < _minShowDelayUs) return;
+  // no segment is due yet: skip per segment housekeeping (changes from UI either trigger() or mark segments for reset)
+  if (!_triggered && !Segment::isResetPending() && _queuedChangesSegId == 255 && !isDue(nowUs, _nextDue)) return;
   bool doShow = false;
 
   _isServicing = true;
-  _segment_index = 0;
+  Segment::clearResetPending();
   Segment::handleRandomPalette(); // move it into for loop when each segment has individual random palette
+  // segments can only be rendered concurrently if they draw into their own framebuffer
+  const bool parallel = WLED_RENDER_WORKERS > 1 && parallelRendering && useSegmentBuffers;
+  uint32_t due = 0; // segments to be rendered in parallel (bitmask)
+  render_context_t &ctx = _ctx[RENDER_CONTEXT_ID()];
+  ctx.segmentIndex = 0;
   for (segment &seg : _segments) {
     // process transition (mode changes in the middle of transition)
     seg.handleTransition();
     // reset the segment runtime data if needed
     seg.resetIfRequired();
+    // keep segment framebuffer and geometry map in sync with segment geometry
+    if (useSegmentBuffers && seg.isActive()) seg.allocateBuffer();
+    else                                     seg.deallocateBuffer();
+    seg.updateGeometryMap();
+    seg.refreshOpacity();
 
     // last condition ensures all solid segments are updated at the same time
-    if (seg.isActive() && (nowUp > seg.next_time || _triggered || (doShow && seg.mode == FX_MODE_STATIC)))
+    // (governor may skip refreshing solid segments along with others and showing frames with only frozen segments)
+    if (seg.isActive() && (isDue(nowUs, seg.next_time) || _triggered || (doShow && seg.mode == FX_MODE_STATIC && !_skipIdleRefresh)))
     {
-      doShow = true;
-      uint16_t delay = FRAMETIME;
-
-      if (!seg.freeze) { //only run effect function if not frozen
-        _virtualSegmentLength = seg.virtualLength();
-        _colors_t[0] = seg.currentColor(0, seg.colors[0]);
-        _colors_t[1] = seg.currentColor(1, seg.colors[1]);
-        _colors_t[2] = seg.currentColor(2, seg.colors[2]);
-        seg.currentPalette(_currentPalette, seg.palette);
-
-        if (!cctFromRgb || correctWB) busses.setSegmentCCT(seg.currentBri(seg.cct, true), correctWB);
-        for (uint8_t c = 0; c < NUM_COLORS; c++) _colors_t[c] = gamma32(_colors_t[c]);
-
-        // effect blending (execute previous effect)
-        // actual code may be a bit more involved as effects have runtime data including allocated memory
-        //if (seg.transitional && seg._modeP) (*_mode[seg._modeP])(progress());
-        delay = (*_mode[seg.currentMode(seg.mode)])();
-        if (seg.mode != FX_MODE_HALLOWEEN_EYES) seg.call++;
-        if (seg.transitional && delay > FRAMETIME) delay = FRAMETIME; // force faster updates during transition
-      }
-
-      seg.next_time = nowUp + delay;
+      if (!seg.freeze || !_skipIdleRefresh) doShow = true;
+      if (seg.freeze) seg.next_time = nowUs + _frametimeUs; //only run effect function if not frozen
+      else if (parallel && ctx.segmentIndex < 32) due |= 1UL << ctx.segmentIndex;
+      else renderSegment(seg, ctx, nowUs);
     }
-    if (_segment_index == _queuedChangesSegId) setUpSegmentFromQueuedChanges();
-    _segment_index++;
+    if (!parallel && ctx.segmentIndex == _queuedChangesSegId) setUpSegmentFromQueuedChanges();
+    ctx.segmentIndex++;
   }
-  _virtualSegmentLength = 0;
+  ctx.virtualLength = 0;
+  #if WLED_RENDER_WORKERS > 1
+  if (due) renderParallel(due, nowUs);
+  if (parallel) setUpSegmentFromQueuedChanges();
+  #endif
   busses.setSegmentCCT(-1);
   _isServicing = false;
   _triggered = false;
 
+  // next deadline (next_time is only final after parallel rendering finished)
+  _nextDue = nowUs + 1000000UL; // poll at least once per second if there are no active segments
+  for (const segment &seg : _segments) {
+    if (!seg.isActive()) continue;
+    if (!seg.next_time) { _nextDue = 0; break; }
+    if ((long)(seg.next_time - _nextDue) < 0) _nextDue = seg.next_time;
+  }
+
   #ifdef WLED_DEBUG
   if (millis() - nowUp > _frametime) DEBUG_PRINTLN(F("Slow effects."));
   #endif
@@ -1123,8 +1529,141 @@ void WS2812FX::service() {
   #ifdef WLED_DEBUG
   if (millis() - nowUp > _frametime) DEBUG_PRINTLN(F("Slow strip."));
   #endif
+  if (doShow) governFrameRate(micros() - nowUs);
 }
 
+/*
+ * Frame rate governor: keeps average pass time (effects + show) within frameBudget so the main loop
+ * (network stack) is not starved. Checked every GOVERNOR_INTERVAL ms, one step at a time:
+ * - over budget: frozen & solid segments stop forcing frames, then most expensive segment renders every other frame, ...
+ * - below 75% of budget: throttling is lifted again in reverse order
+ */
+#define GOVERNOR_INTERVAL     250
+#define GOVERNOR_MAX_THROTTLE 7   // at most 1/8 of target frame rate
+void WS2812FX::governFrameRate(uint32_t passUs) {
+  _passTime.add(passUs);
+  unsigned long nowUp = millis();
+  if (nowUp - _lastGovern < GOVERNOR_INTERVAL) return;
+  _lastGovern = nowUp;
+
+  uint32_t cost   = _passTime.getAvg();
+  uint32_t budget = frameBudget * 1000UL;
+  Segment *adjust = nullptr;
+  if (budget && cost > budget) {
+    if (!_skipIdleRefresh) {
+      _skipIdleRefresh = true;
+      return;
+    }
+    // throttle segment with most expensive effect
+    uint32_t worst = 0;
+    for (segment &seg : _segments) {
+      if (!seg.isActive() || seg.freeze || seg.getThrottle() >= GOVERNOR_MAX_THROTTLE) continue;
+      if (seg.getEffectTime().getAvg() > worst) { worst = seg.getEffectTime().getAvg(); adjust = &seg; }
+    }
+    if (adjust) adjust->setThrottle(adjust->getThrottle() + 1);
+  } else if (!budget || cost < budget * 3 / 4) {
+    // release most throttled segment first
+    for (segment &seg : _segments) {
+      if (seg.getThrottle() && (!adjust || seg.getThrottle() > adjust->getThrottle())) adjust = &seg;
+    }
+    if (adjust) adjust->setThrottle(adjust->getThrottle() - 1);
+    else        _skipIdleRefresh = false;
+  }
+}
+
+uint32_t WS2812FX::getTimeToNextFrame() {
+  if (_triggered || Segment::isResetPending() || _queuedChangesSegId != 255 || isBenchmarkPending()) return 0;
+  if (!_nextDue) return 0;
+  unsigned long nowUs = micros();
+  long wait = _nextDue - nowUs;
+  long gate = _lastShowUs + _minShowDelayUs - nowUs;
+  if (gate > wait) wait = gate;
+  return wait > 0 ? wait / 1000 : 0;
+}
+
+// runs effect function of a segment using given render context
+void WS2812FX::renderSegment(Segment &seg, render_context_t &ctx, unsigned long nowUs) {
+  ctx.segment = &seg;
+  ctx.virtualLength = seg.virtualLength();
+  ctx.colors[0] = seg.currentColor(0, seg.colors[0]);
+  ctx.colors[1] = seg.currentColor(1, seg.colors[1]);
+  ctx.colors[2] = seg.currentColor(2, seg.colors[2]);
+  seg.currentPalette(ctx.palette, seg.palette);
+  seg.updatePaletteCache(ctx.palette); // only rebuilds if palette changed since last frame
+
+  // segments with framebuffer get CCT applied when composited in show()
+  if (!seg.hasBuffer() && (!cctFromRgb || correctWB)) busses.setSegmentCCT(seg.currentBri(seg.cct, true), correctWB);
+  for (uint8_t c = 0; c < NUM_COLORS; c++) ctx.colors[c] = gamma32(ctx.colors[c]);
+
+  // effect blending (execute previous effect)
+  // actual code may be a bit more involved as effects have runtime data including allocated memory
+  //if (seg.transitional && seg._modeP) (*_mode[seg._modeP])(progress());
+  uint32_t t0 = micros();
+  uint16_t delay = (*_mode[seg.currentMode(seg.mode)])();
+  seg.getEffectTime().add(micros() - t0);
+  ctx.segment = nullptr; // SEGMENT refers to _segments[segmentIndex] again
+  if (seg.mode != FX_MODE_HALLOWEEN_EYES) seg.call++;
+  if (seg.transitional && delay > FRAMETIME) delay = FRAMETIME; // force faster updates during transition
+  // FRAMETIME is rounded to whole ms, effects asking for one frame are scheduled at exact target frame rate
+  seg.next_time = nowUs + (delay == FRAMETIME ? _frametimeUs : delay * 1000UL) + seg.getThrottle() * _frametimeUs;
+  if (!seg.next_time) seg.next_time = 1; // 0 is reserved for due now
+}
+
+// renders segments in bitmask using render context of calling task
+void WS2812FX::renderSegments(uint32_t segments, unsigned long nowUs) {
+  render_context_t &ctx = _ctx[RENDER_CONTEXT_ID()];
+  for (size_t i = 0; i < _segments.size() && i < 32; i++) {
+    if (!(segments & (1UL << i))) continue;
+    ctx.segmentIndex = i;
+    renderSegment(_segments[i], ctx, nowUs);
+  }
+  ctx.virtualLength = 0;
+}
+
+#if WLED_RENDER_WORKERS > 1
+/*
+ * Distributes due segments across main loop and render workers by pixel count.
+ * Effects only touch their own segment (and its framebuffer), shared state is kept in per-worker
+ * render contexts and segment data allocation is locked. Effects (i.e. from usermods) using
+ * static variables are not reentrant and may misbehave in this mode.
+ */
+void WS2812FX::renderParallel(uint32_t segments, unsigned long nowUs) {
+  uint32_t load[WLED_RENDER_WORKERS] = {0};
+  uint32_t share[WLED_RENDER_WORKERS] = {0};
+  for (size_t i = 0; i < _segments.size() && i < 32; i++) {
+    if (!(segments & (1UL << i))) continue;
+    size_t w = 0; // segments without framebuffer (allocation failed) paint physical pixels and stay on main loop
+    if (_segments[i].hasBuffer()) for (size_t k = 1; k < WLED_RENDER_WORKERS; k++) if (load[k] < load[w]) w = k;
+    share[w] |= 1UL << i;
+    load[w]  += _segments[i].length();
+  }
+
+  _isRenderingParallel = true;
+  for (size_t k = 1; k < WLED_RENDER_WORKERS; k++) {
+    if (!share[k]) continue;
+    TaskWorker &worker = _renderWorker[k-1];
+    #ifdef ARDUINO_ARCH_ESP32
+    if (!worker.isRunning()) worker.begin("render", 8192, 1, xPortGetCoreID() ? 0 : 1); // effects may need as much stack as loop()
+    #else
+    if (!worker.isRunning()) worker.begin("render");
+    #endif
+    _renderJob[k-1] = {this, share[k], nowUs, (uint8_t)k};
+    worker.post(renderJob, &_renderJob[k-1]); // runs inline if worker could not be started
+  }
+  renderSegments(share[0], nowUs);
+  for (size_t k = 1; k < WLED_RENDER_WORKERS; k++) _renderWorker[k-1].wait();
+  _isRenderingParallel = false;
+}
+
+void WS2812FX::renderJob(void *job) {
+  RenderJob *j = static_cast<RenderJob*>(job);
+  uint8_t prevContext = renderContextId; // job may be run inline by main loop
+  renderContextId = j->context;
+  j->strip->renderSegments(j->segments, j->nowUs);
+  renderContextId = prevContext;
+}
+#endif
+
 void IRAM_ATTR WS2812FX::setPixelColor(int i, uint32_t col)
 {
   if (i < customMappingSize) i = customMappingTable[i];
@@ -1132,6 +1671,18 @@ void IRAM_ATTR WS2812FX::setPixelColor(int i, uint32_t col)
   busses.setPixelColor(i, col);
 }
 
+void WS2812FX::setPixelColors(int i, uint16_t count, const uint32_t *c)
+{
+  if (i < 0 || i >= _length) return;
+  if (count > _length - i) count = _length - i;
+  if (i < customMappingSize) { // mapped pixels have to be set one by one
+    uint16_t mapped = MIN(count, customMappingSize - i);
+    for (uint16_t j = 0; j < mapped; j++) setPixelColor(i + j, c[j]);
+    i += mapped; count -= mapped; c += mapped;
+  }
+  if (count) busses.setPixelColors(i, count, c);
+}
+
 uint32_t WS2812FX::getPixelColor(uint16_t i)
 {
   if (i < customMappingSize) i = customMappingTable[i];
@@ -1161,6 +1712,7 @@ uint8_t WS2812FX::estimateCurrentAndLimitBri() {
 
   if (ablMilliampsMax < 150 || actualMilliampsPerLed == 0) { //0 mA per LED and too low numbers turn off calculation
     currentMilliamps = 0;
+    for (uint_fast8_t bNum = 0; bNum < busses.getNumBusses(); bNum++) busses.getBus(bNum)->setUsedCurrent(0);
     return _brightness;
   }
 
@@ -1173,13 +1725,17 @@ uint8_t WS2812FX::estimateCurrentAndLimitBri() {
 
   size_t pLen = 0; //getLengthPhysical();
   size_t powerSum = 0;
+  uint32_t busPowerSums[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES] = {0};
   for (uint_fast8_t bNum = 0; bNum < busses.getNumBusses(); bNum++) {
     Bus *bus = busses.getBus(bNum);
     if (!IS_DIGITAL(bus->getType())) continue; //exclude non-digital network busses
     uint16_t len = bus->getLength();
     pLen += len;
     uint32_t busPowerSum = 0;
-    for (uint_fast16_t i = 0; i < len; i++) { //sum up the usage of each LED
+    uint32_t sum, max3;
+    if (bus->getPowerSums(sum, max3)) { // buffered busses keep channel sums up to date as pixels are written
+      busPowerSum = useWackyWS2815PowerModel ? max3 : sum;
+    } else for (uint_fast16_t i = 0; i < len; i++) { //sum up the usage of each LED
       uint32_t c = bus->getPixelColor(i); // always returns original or restored color without brightness scaling
       byte r = R(c), g = G(c), b = B(c), w = W(c);
 
@@ -1194,6 +1750,7 @@ uint8_t WS2812FX::estimateCurrentAndLimitBri() {
       busPowerSum *= 3;
       busPowerSum >>= 2; //same as /= 4
     }
+    busPowerSums[bNum] = busPowerSum;
     powerSum += busPowerSum;
   }
 
@@ -1216,15 +1773,35 @@ uint8_t WS2812FX::estimateCurrentAndLimitBri() {
   currentMilliamps = (powerSum * newBri) / 255;
   currentMilliamps += MA_FOR_ESP; //add power of ESP back to estimate
   currentMilliamps += pLen; //add standby power (1mA/LED) back to estimate
+
+  // per-bus estimate (including 1mA/LED standby power) for info
+  for (uint_fast8_t bNum = 0; bNum < busses.getNumBusses(); bNum++) {
+    Bus *bus = busses.getBus(bNum);
+    if (!IS_DIGITAL(bus->getType())) continue;
+    size_t busMilliamps = ((size_t)busPowerSums[bNum] * actualMilliampsPerLed) / 765;
+    bus->setUsedCurrent((busMilliamps * newBri) / 255 + bus->getLength());
+  }
   return newBri;
 }
 
 void WS2812FX::show(void) {
+  // composite segment framebuffers into physical pixels (unless realtime data is written directly to the strip)
+  if (useSegmentBuffers && (!realtimeMode || realtimeOverride || useMainSegmentOnly)) {
+    for (segment &seg : _segments) {
+      if (!seg.isActive() || !seg.hasBuffer()) continue;
+      if (!cctFromRgb || correctWB) busses.setSegmentCCT(seg.currentBri(seg.cct, true), correctWB);
+      seg.drawBuffer();
+    }
+    busses.setSegmentCCT(-1);
+  }
+
   // avoid race condition, caputre _callback value
   show_callback callback = _callback;
   if (callback) callback();
 
+  uint32_t t0 = micros();
   uint8_t newBri = estimateCurrentAndLimitBri();
+  _ablTime.add(micros() - t0);
   busses.setBrightness(newBri); // "repaints" all pixels if brightness changed
 
   // some buses send asynchronously and this method will return before
@@ -1238,11 +1815,32 @@ void WS2812FX::show(void) {
   if (newBri < _brightness) busses.setBrightness(_brightness);
 
   unsigned long now = millis();
-  size_t diff = now - _lastShow;
-  size_t fpsCurr = 200;
-  if (diff > 0) fpsCurr = 1000 / diff;
+  unsigned long nowUs = micros();
+  uint32_t diff = nowUs - _lastShowUs;
+  uint32_t fpsCurr = WLED_MAX_FPS;
+  if (diff > 0) fpsCurr = 1000000UL / diff;
   _cumulativeFps = (3 * _cumulativeFps + fpsCurr +2) >> 2;   // "+2" for proper rounding (2/4 = 0.5)
+  // jitter is only meaningful while frames are produced at target rate (not for idle or static effects)
+  if (diff < 2 * _frametimeUs) {
+    _frameInterval.add(diff);
+    _frameJitter.add(diff > _frametimeUs ? diff - _frametimeUs : _frametimeUs - diff);
+  }
   _lastShow = now;
+  _lastShowUs = nowUs;
+}
+
+// returns amount of RAM used by segment geometry maps
+size_t WS2812FX::getSegmentMapsSize() {
+  size_t size = 0;
+  for (segment &seg : _segments) size += seg.geometryMapSize();
+  return size;
+}
+
+// returns amount of RAM used by segment framebuffers
+size_t WS2812FX::getSegmentBuffersSize() {
+  size_t size = 0;
+  for (segment &seg : _segments) size += seg.bufferSize();
+  return size;
 }
 
 /**
@@ -1262,9 +1860,12 @@ uint16_t WS2812FX::getFps() {
   return _cumulativeFps +1;
 }
 
-void WS2812FX::setTargetFps(uint8_t fps) {
-  if (fps > 0 && fps <= 120) _targetFps = fps;
-  _frametime = 1000 / _targetFps;
+void WS2812FX::setTargetFps(uint16_t fps) {
+  if (fps > 0 && fps <= WLED_MAX_FPS) _targetFps = fps;
+  _frametime   = 1000 / _targetFps;
+  _frametimeUs = 1000000UL / _targetFps;
+  // high refresh mode: whole ms MIN_SHOW_DELAY would cap frame rate, pace shows at exact target frame time instead
+  _minShowDelayUs = _frametime < 8 ? _frametimeUs : MIN_SHOW_DELAY * 1000UL;
 }
 
 void WS2812FX::setMode(uint8_t segid, uint8_t m) {
@@ -1313,8 +1914,8 @@ void WS2812FX::setBrightness(uint8_t b, bool direct) {
   // so we need to force an update to existing buffer
   busses.setBrightness(b);
   if (!direct) {
-    unsigned long t = millis();
-    if (_segments[0].next_time > t + 22 && t - _lastShow > MIN_SHOW_DELAY) trigger(); //apply brightness change immediately if no refresh soon
+    unsigned long t = micros();
+    if ((long)(_segments[0].next_time - t) > 22000 && t - _lastShowUs > _minShowDelayUs) trigger(); //apply brightness change immediately if no refresh soon
   }
 }
 
@@ -1431,7 +2032,7 @@ void WS2812FX::setSegment(uint8_t segId, uint16_t i1, uint16_t i2, uint8_t group
 
   if (_queuedChangesSegId == segId) _queuedChangesSegId = 255; // cancel queued change if already queued for this segment
 
-  if (segId < getMaxSegments() && segId == getCurrSegmentId() && isServicing()) { // queue change to prevent concurrent access
+  if (segId < getMaxSegments() && (segId == getCurrSegmentId() || isRenderingParallel()) && isServicing()) { // queue change to prevent concurrent access
     // queuing a change for a second segment will lead to the loss of the first change if not yet applied
     // however this is not a problem as the queued change is applied immediately after the effect function in that segment returns
     _qStart  = i1; _qStop   = i2; _qStartY = startY; _qStopY  = stopY;
@@ -1581,12 +2182,14 @@ bool WS2812FX::checkSegmentAlignment() {
 
 //After this function is called, setPixelColor() will use that segment (offsets, grouping, ... will apply)
 //Note: If called in an interrupt (e.g. JSON API), original segment must be restored,
-//otherwise it can lead to a crash on ESP32 because _segment_index is modified while in use by the main thread
+//otherwise it can lead to a crash on ESP32 because render context is modified while in use by the main thread
 uint8_t WS2812FX::setPixelSegment(uint8_t n) {
-  uint8_t prevSegId = _segment_index;
+  render_context_t &ctx = _ctx[RENDER_CONTEXT_ID()];
+  uint8_t prevSegId = ctx.segmentIndex;
   if (n < _segments.size()) {
-    _segment_index = n;
-    _virtualSegmentLength = _segments[_segment_index].virtualLength();
+    ctx.segmentIndex = n;
+    ctx.segment = nullptr;
+    ctx.virtualLength = _segments[n].virtualLength();
   }
   return prevSegId;
 }
@@ -1681,6 +2284,7 @@ bool WS2812FX::deserializeMap(uint8_t n) {
       customMappingSize = 0;
       delete[] customMappingTable;
       customMappingTable = nullptr;
+      _mappingGen++;
     }
     return false;
   }
@@ -1710,6 +2314,7 @@ bool WS2812FX::deserializeMap(uint8_t n) {
       customMappingTable[i] = (uint16_t) (map[i]<0 ? 0xFFFFU : map[i]);
     }
   }
+  _mappingGen++; // segments will rebuild their geometry maps
 
   releaseJSONBufferLock();
   return true;
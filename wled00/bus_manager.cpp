@@ -15,7 +15,7 @@ uint16_t approximateKelvinFromRGB(uint32_t rgb);
 void colorRGBtoRGBW(byte* rgb);
 
 //udp.cpp
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, byte *buffer, uint8_t bri=255, bool isRGBW=false);
+uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, byte *buffer, uint8_t bri=255, bool isRGBW=false, const uint8_t *packetMask=nullptr, uint16_t universeOffset=0);
 
 // enable additional debug output
 #if defined(WLED_DEBUG_HOST)
@@ -102,6 +102,10 @@ BusDigital::BusDigital(BusConfig &bc, uint8_t nr, const ColorOrderMap &com)
 , _skip(bc.skipAmount) //sacrificial pixels
 , _colorOrder(bc.colorOrder)
 , _colorOrderMap(com)
+, _powerSum(0)
+, _powerMax3(0)
+, _dataTx(nullptr)
+, _briTx(255)
 {
   if (!IS_DIGITAL(bc.type) || !bc.count) return;
   if (!pinManager.allocatePin(bc.pins[0], true, PinOwner::BusDigital)) return;
@@ -126,32 +130,53 @@ BusDigital::BusDigital(BusConfig &bc, uint8_t nr, const ColorOrderMap &com)
   DEBUG_PRINTF("%successfully inited strip %u (len %u) with type %u and pins %u,%u (itype %u)\n", _valid?"S":"Uns", nr, bc.count, bc.type, _pins[0], _pins[1], _iType);
 }
 
-void BusDigital::show() {
-  if (!_valid) return;
-  if (_buffering) { // should be _data != nullptr, but that causes ~20% FPS drop
-    size_t channels = Bus::hasWhite(_type) + 3*Bus::hasRGB(_type);
-    for (size_t i=0; i<_len; i++) {
-      size_t offset = i*channels;
-      uint8_t co = _colorOrderMap.getPixelColorOrder(i+_start, _colorOrder);
-      uint32_t c;
-      if (_type == TYPE_WS2812_1CH_X3) { // map to correct IC, each controls 3 LEDs (_len is always a multiple of 3)
-        switch (i%3) {
-          case 0: c = RGBW32(_data[offset]  , _data[offset+1], _data[offset+2], 0); break;
-          case 1: c = RGBW32(_data[offset-1], _data[offset]  , _data[offset+1], 0); break;
-          case 2: c = RGBW32(_data[offset-2], _data[offset-1], _data[offset]  , 0); break;
-        }
-      } else {
-        c = RGBW32(_data[offset],_data[offset+1],_data[offset+2],(Bus::hasWhite(_type)?_data[offset+3]:0));
+void BusDigital::transferPixels(const uint8_t *data, uint8_t bri, const ColorOrderMap &com) {
+  PolyBus::setBrightness(_busPtr, _iType, bri); // luminance is applied when setting pixels
+  size_t channels = Bus::hasWhite(_type) + 3*Bus::hasRGB(_type);
+  for (size_t i=0; i<_len; i++) {
+    size_t offset = i*channels;
+    uint8_t co = com.getPixelColorOrder(i+_start, _colorOrder);
+    uint32_t c;
+    if (_type == TYPE_WS2812_1CH_X3) { // map to correct IC, each controls 3 LEDs (_len is always a multiple of 3)
+      switch (i%3) {
+        case 0: c = RGBW32(data[offset]  , data[offset+1], data[offset+2], 0); break;
+        case 1: c = RGBW32(data[offset-1], data[offset]  , data[offset+1], 0); break;
+        case 2: c = RGBW32(data[offset-2], data[offset-1], data[offset]  , 0); break;
       }
-      uint16_t pix = i;
-      if (_reversed) pix  = _len - pix -1;
-      else           pix += _skip;
-      PolyBus::setPixelColor(_busPtr, _iType, pix, c, co);
+    } else {
+      c = RGBW32(data[offset],data[offset+1],data[offset+2],(Bus::hasWhite(_type)?data[offset+3]:0));
     }
+    uint16_t pix = i;
+    if (_reversed) pix  = _len - pix -1;
+    else           pix += _skip;
+    PolyBus::setPixelColor(_busPtr, _iType, pix, c, co);
   }
+}
+
+void BusDigital::show() {
+  if (!_valid) return;
+  if (_buffering) transferPixels(_data, _bri, _colorOrderMap); // should be _data != nullptr, but that causes ~20% FPS drop
   PolyBus::show(_busPtr, _iType, !_buffering); // faster if buffer consistency is not important
 }
 
+// only buffered busses can be pipelined, others are rendered directly into NeoPixelBus buffer
+bool BusDigital::latch() {
+  if (!_valid || !_buffering) return false;
+  size_t len = _len * (Bus::hasWhite(_type) + 3*Bus::hasRGB(_type));
+  if (!_dataTx) _dataTx = (uint8_t*) malloc(len);
+  if (!_dataTx) return false;
+  memcpy(_dataTx, _data, len);
+  _briTx = _bri;
+  _colorOrderMapTx = _colorOrderMap; // transmit() must not read the map while updateColorOrderMap() copies it
+  return true;
+}
+
+void BusDigital::transmit() {
+  if (!_valid || !_dataTx) return;
+  transferPixels(_dataTx, _briTx, _colorOrderMapTx);
+  PolyBus::show(_busPtr, _iType, false);
+}
+
 bool BusDigital::canShow() {
   if (!_valid) return true;
   return PolyBus::canShow(_busPtr, _iType);
@@ -167,10 +192,9 @@ void BusDigital::setBrightness(uint8_t b) {
   #endif
   uint8_t prevBri = _bri;
   Bus::setBrightness(b);
+  if (_buffering) return; // applied in show()/transmit(), NeoPixelBus may be in use by worker task
   PolyBus::setBrightness(_busPtr, _iType, b);
 
-  if (_buffering) return;
-
   // must update/repaint every LED in the NeoPixelBus buffer to the new brightness
   // the only case where repainting is unnecessary is when all pixels are set after the brightness change but before the next show
   // (which we can't rely on)
@@ -199,13 +223,22 @@ void IRAM_ATTR BusDigital::setPixelColor(uint16_t pix, uint32_t c) {
   if (_buffering) { // should be _data != nullptr, but that causes ~20% FPS drop
     size_t channels = Bus::hasWhite(_type) + 3*Bus::hasRGB(_type);
     size_t offset = pix*channels;
+    updatePowerSums(offset, c);
+    uint8_t *d = _data + offset;
+    uint8_t diff = 0;
     if (Bus::hasRGB(_type)) {
-      _data[offset++] = R(c);
-      _data[offset++] = G(c);
-      _data[offset++] = B(c);
+      diff |= (d[0] ^ R(c)) | (d[1] ^ G(c)) | (d[2] ^ B(c));
+      *d++ = R(c);
+      *d++ = G(c);
+      *d++ = B(c);
+    }
+    if (Bus::hasWhite(_type)) {
+      diff |= *d ^ W(c);
+      *d = W(c);
     }
-    if (Bus::hasWhite(_type)) _data[offset] = W(c);
+    if (diff) _dirty = true;
   } else {
+    _dirty = true; // NeoPixelBus buffer holds scaled colors, it is not compared
     if (_reversed) pix  = _len - pix -1;
     else           pix += _skip;
     uint8_t co = _colorOrderMap.getPixelColorOrder(pix+_start, _colorOrder);
@@ -223,6 +256,60 @@ void IRAM_ATTR BusDigital::setPixelColor(uint16_t pix, uint32_t c) {
   }
 }
 
+// bulk version of setPixelColor(), avoids virtual call and per-pixel buffering checks
+void BusDigital::setPixelColors(uint16_t pix, uint16_t count, const uint32_t *c) {
+  if (!_valid) return;
+  if (!_buffering || !Bus::hasRGB(_type)) {
+    for (uint16_t i = 0; i < count; i++) BusDigital::setPixelColor(pix + i, c[i]);
+    return;
+  }
+  const bool hasW = Bus::hasWhite(_type);
+  const size_t channels = 3 + hasW;
+  uint8_t *dst = _data + pix*channels;
+  uint8_t diff = 0;
+  for (uint16_t i = 0; i < count; i++) {
+    uint32_t col = c[i];
+    if (hasW) col = autoWhiteCalc(col);
+    if (_cct >= 1900) col = colorBalanceFromKelvin(_cct, col); //color correction from CCT
+    updatePowerSums(dst - _data, col);
+    diff |= (dst[0] ^ R(col)) | (dst[1] ^ G(col)) | (dst[2] ^ B(col));
+    *dst++ = R(col);
+    *dst++ = G(col);
+    *dst++ = B(col);
+    if (hasW) {
+      diff |= *dst ^ W(col);
+      *dst++ = W(col);
+    }
+  }
+  if (diff) _dirty = true;
+}
+
+/*
+ * Keeps ABL channel sums in sync with _data so WS2812FX::estimateCurrentAndLimitBri()
+ * does not need to scan all pixels. Must be called before pixel at offset is overwritten.
+ */
+void BusDigital::updatePowerSums(size_t offset, uint32_t c) {
+  const uint8_t *d = _data + offset;
+  if (Bus::hasRGB(_type)) {
+    uint8_t r = R(c), g = G(c), b = B(c);
+    uint8_t rgbMax = r > g ? (r > b ? r : b) : (g > b ? g : b);
+    uint8_t oldMax = d[0] > d[1] ? (d[0] > d[2] ? d[0] : d[2]) : (d[1] > d[2] ? d[1] : d[2]);
+    _powerSum  += r + g + b - (d[0] + d[1] + d[2]);
+    if (Bus::hasWhite(_type)) _powerSum += W(c) - d[3];
+    _powerMax3 += 3 * (rgbMax - oldMax);
+  } else { // single channel types read back as W in all channels
+    _powerSum  += 4 * (W(c) - d[0]);
+    _powerMax3 += 3 * (W(c) - d[0]);
+  }
+}
+
+bool BusDigital::getPowerSums(uint32_t &sum, uint32_t &max3) {
+  if (!_valid || !_buffering) return false;
+  sum  = _powerSum;
+  max3 = _powerMax3;
+  return true;
+}
+
 // returns original color if global buffering is enabled, else returns lossly restored color from bus
 uint32_t BusDigital::getPixelColor(uint16_t pix) {
   if (!_valid) return 0;
@@ -261,6 +348,29 @@ uint8_t BusDigital::getPins(uint8_t* pinArray) {
   return numPins;
 }
 
+// approximate time the protocol needs to send all LEDs
+uint32_t BusDigital::getFrameTime() {
+  uint32_t len = _len + _skip;
+  if (IS_2PIN(_type)) {
+    // clocked chips: start & end frame plus 32 bits per LED (24 for WS2801, 16 for LPD6803)
+    uint8_t bits = _type == TYPE_WS2801 ? 24 : (_type == TYPE_LPD6803 ? 16 : 32);
+    return ((len + 2) * bits * 1000UL) / (_frequencykHz ? _frequencykHz : 2000U);
+  }
+  // single wire: 1.25us per bit (2.5us at 400kHz) followed by >280us reset
+  uint8_t bits = 24;
+  switch (_type) {
+    case TYPE_SK6812_RGBW:
+    case TYPE_TM1814:    bits = 32; break;
+    case TYPE_UCS8903:   bits = 48; break; // 16 bit channels
+    case TYPE_UCS8904:   bits = 64; break;
+    case TYPE_WS2812_1CH_X3:
+    case TYPE_WS2812_2CH_X3:
+    case TYPE_WS2812_WWA: len = (len + 2) / 3; break; // several LEDs per IC
+  }
+  uint32_t bitNs = _type == TYPE_WS2811_400KHZ ? 2500 : 1250;
+  return (len * bits * bitNs) / 1000 + 300;
+}
+
 void BusDigital::setColorOrder(uint8_t colorOrder) {
   // upper nibble contains W swap information
   if ((colorOrder & 0x0F) > 5) return;
@@ -279,6 +389,8 @@ void BusDigital::cleanup() {
   _valid = false;
   _busPtr = nullptr;
   if (_data != nullptr) freeData();
+  if (_dataTx != nullptr) free(_dataTx);
+  _dataTx = nullptr;
   pinManager.deallocatePin(_pins[1], PinOwner::BusDigital);
   pinManager.deallocatePin(_pins[0], PinOwner::BusDigital);
 }
@@ -336,6 +448,9 @@ void BusPwm::setPixelColor(uint16_t pix, uint32_t c) {
     cct = (approximateKelvinFromRGB(c) - 1900) >> 5;
   }
 
+  uint8_t prev[5];
+  memcpy(prev, _data, sizeof(prev));
+
   uint8_t ww, cw;
   #ifdef WLED_USE_IC_CCT
   ww = w;
@@ -369,6 +484,7 @@ void BusPwm::setPixelColor(uint16_t pix, uint32_t c) {
       _data[0] = r; _data[1] = g; _data[2] = b;
       break;
   }
+  if (memcmp(prev, _data, sizeof(prev))) _dirty = true;
 }
 
 //does no index check
@@ -440,7 +556,9 @@ void BusOnOff::setPixelColor(uint16_t pix, uint32_t c) {
   uint8_t g = G(c);
   uint8_t b = B(c);
   uint8_t w = W(c);
-  _data[0] = bool(r|g|b|w) && bool(_bri) ? 0xFF : 0;
+  uint8_t onoff = bool(r|g|b|w) && bool(_bri) ? 0xFF : 0;
+  if (_data[0] != onoff) _dirty = true;
+  _data[0] = onoff;
 }
 
 uint32_t BusOnOff::getPixelColor(uint16_t pix) {
@@ -460,9 +578,17 @@ uint8_t BusOnOff::getPins(uint8_t* pinArray) {
 }
 
 
-BusNetwork::BusNetwork(BusConfig &bc)
+BusNetwork::BusNetwork(BusConfig &bc, uint16_t universeOffset)
 : Bus(bc.type, bc.start, bc.autoWhite, bc.count)
+, _universeOffset(universeOffset)
 , _broadcastLock(false)
+, _dataTx(nullptr)
+, _briTx(255)
+, _packets(nullptr)
+, _packetsLen(0)
+, _packetsTx(nullptr)
+, _briSent(0)
+, _lastKeyframe(0)
 {
   switch (bc.type) {
     case TYPE_NET_ARTNET_RGB:
@@ -481,6 +607,10 @@ BusNetwork::BusNetwork(BusConfig &bc)
   _UDPchannels = _rgbw ? 4 : 3;
   _client = IPAddress(bc.pins[0],bc.pins[1],bc.pins[2],bc.pins[3]);
   _valid = (allocData(_len * _UDPchannels) != nullptr);
+  if (_valid && _UDPtype == 0) { // DDP addresses data by offset, unchanged packets can be left out
+    _packetsLen = ((_len * _UDPchannels - 1) / DDP_CHANNELS_PER_PACKET + 8) / 8;
+    _packets = (uint8_t*) calloc(2 * _packetsLen, 1); // without it complete frames are sent
+  }
 }
 
 void BusNetwork::setPixelColor(uint16_t pix, uint32_t c) {
@@ -488,10 +618,39 @@ void BusNetwork::setPixelColor(uint16_t pix, uint32_t c) {
   if (_rgbw) c = autoWhiteCalc(c);
   if (_cct >= 1900) c = colorBalanceFromKelvin(_cct, c); //color correction from CCT
   uint16_t offset = pix * _UDPchannels;
+  uint8_t diff = (_data[offset] ^ R(c)) | (_data[offset+1] ^ G(c)) | (_data[offset+2] ^ B(c));
   _data[offset]   = R(c);
   _data[offset+1] = G(c);
   _data[offset+2] = B(c);
-  if (_rgbw) _data[offset+3] = W(c);
+  if (_rgbw) {
+    diff |= _data[offset+3] ^ W(c);
+    _data[offset+3] = W(c);
+  }
+  if (diff) {
+    _dirty = true;
+    markPacket(offset);
+  }
+}
+
+void BusNetwork::setPixelColors(uint16_t pix, uint16_t count, const uint32_t *c) {
+  if (!_valid || pix >= _len) return;
+  if (count > _len - pix) count = _len - pix;
+  uint8_t *dst = _data + pix * _UDPchannels;
+  for (uint16_t i = 0; i < count; i++) {
+    uint32_t col = c[i];
+    if (_rgbw) col = autoWhiteCalc(col);
+    if (_cct >= 1900) col = colorBalanceFromKelvin(_cct, col); //color correction from CCT
+    uint8_t diff = (dst[0] ^ R(col)) | (dst[1] ^ G(col)) | (dst[2] ^ B(col));
+    if (_rgbw) diff |= dst[3] ^ W(col);
+    if (diff) {
+      _dirty = true;
+      markPacket(dst - _data);
+    }
+    *dst++ = R(col);
+    *dst++ = G(col);
+    *dst++ = B(col);
+    if (_rgbw) *dst++ = W(col);
+  }
 }
 
 uint32_t BusNetwork::getPixelColor(uint16_t pix) {
@@ -500,10 +659,44 @@ uint32_t BusNetwork::getPixelColor(uint16_t pix) {
   return RGBW32(_data[offset], _data[offset+1], _data[offset+2], (_rgbw ? _data[offset+3] : 0));
 }
 
+/*
+ * Returns mask of DDP packets changed since last call (nullptr if complete frame has to be sent) and starts a new one.
+ * Complete frames are sent when brightness changed (packets are scaled on send) and every DDP_KEYFRAME_INTERVAL ms,
+ * so receivers that missed a packet or (re)started recover.
+ */
+uint8_t *BusNetwork::takePackets(uint8_t bri) {
+  if (!_packets) return nullptr;
+  uint8_t *mask = _packets + _packetsLen;
+  memcpy(mask, _packets, _packetsLen);
+  memset(_packets, 0, _packetsLen);
+  uint32_t now = millis();
+  if (bri == _briSent && now - _lastKeyframe < DDP_KEYFRAME_INTERVAL) return mask;
+  _briSent = bri;
+  _lastKeyframe = now;
+  return nullptr;
+}
+
 void BusNetwork::show() {
   if (!_valid || !canShow()) return;
   _broadcastLock = true;
-  realtimeBroadcast(_UDPtype, _client, _len, _data, _bri, _rgbw);
+  realtimeBroadcast(_UDPtype, _client, _len, _data, _bri, _rgbw, takePackets(_bri), _universeOffset);
+  _broadcastLock = false;
+}
+
+bool BusNetwork::latch() {
+  if (!_valid) return false;
+  if (!_dataTx) _dataTx = (uint8_t*) malloc(_len * _UDPchannels);
+  if (!_dataTx) return false;
+  memcpy(_dataTx, _data, _len * _UDPchannels);
+  _briTx = _bri;
+  _packetsTx = takePackets(_bri); // previous transmit() has finished, its mask can be reused
+  return true;
+}
+
+void BusNetwork::transmit() {
+  if (!_valid || !_dataTx) return;
+  _broadcastLock = true;
+  realtimeBroadcast(_UDPtype, _client, _len, _dataTx, _briTx, _rgbw, _packetsTx, _universeOffset);
   _broadcastLock = false;
 }
 
@@ -518,6 +711,10 @@ void BusNetwork::cleanup() {
   _type = I_NONE;
   _valid = false;
   freeData();
+  if (_dataTx != nullptr) free(_dataTx);
+  _dataTx = nullptr;
+  if (_packets != nullptr) free(_packets);
+  _packets = _packetsTx = nullptr;
 }
 
 
@@ -545,8 +742,16 @@ uint32_t BusManager::memUsage(BusConfig &bc) {
 
 int BusManager::add(BusConfig &bc) {
   if (getNumBusses() - getNumVirtualBusses() >= WLED_MAX_BUSSES) return -1;
+  freeRouting(); // will be rebuilt in finalizeInit()
   if (bc.type >= TYPE_NET_DDP_RGB && bc.type < 96) {
-    busses[numBusses] = new BusNetwork(bc);
+    // E1.31/Art-Net busses send consecutive universes following those of earlier busses of the same protocol
+    uint16_t universeOffset = 0;
+    if (bc.type == TYPE_NET_E131_RGB || bc.type == TYPE_NET_ARTNET_RGB) {
+      for (uint8_t i = 0; i < numBusses; i++) {
+        if (busses[i]->getType() == bc.type) universeOffset += static_cast<BusNetwork*>(busses[i])->getUniverseCount();
+      }
+    }
+    busses[numBusses] = new BusNetwork(bc, universeOffset);
   } else if (IS_DIGITAL(bc.type)) {
     busses[numBusses] = new BusDigital(bc, numBusses, colorOrderMap);
   } else if (bc.type == TYPE_ONOFF) {
@@ -561,24 +766,173 @@ int BusManager::add(BusConfig &bc) {
 void BusManager::removeAll() {
   DEBUG_PRINTLN(F("Removing all."));
   //prevents crashes due to deleting busses while in use.
+  _worker.wait();
   while (!canAllShow()) yield();
+  freeRouting();
   for (uint8_t i = 0; i < numBusses; i++) delete busses[i];
   numBusses = 0;
 }
 
+void BusManager::freeRouting() {
+  if (_pixelBus) delete[] _pixelBus;
+  _pixelBus = nullptr;
+  _pixelBusLen = 0;
+  _numRanges = 0;
+}
+
+//do not call this method from system context (network callback)
+void BusManager::buildRouting() {
+  freeRouting();
+  if (!numBusses) return;
+
+  // sorted (by start) list of bus ranges
+  uint16_t totalLen = 0;
+  for (uint8_t i = 0; i < numBusses; i++) {
+    uint16_t bStart = busses[i]->getStart();
+    uint16_t bEnd   = bStart + busses[i]->getLength();
+    if (bEnd > totalLen) totalLen = bEnd;
+    uint8_t j = _numRanges++;
+    for (; j > 0 && _rangeStart[j-1] > bStart; j--) {
+      _rangeStart[j] = _rangeStart[j-1];
+      _rangeEnd[j]   = _rangeEnd[j-1];
+      _rangeBus[j]   = _rangeBus[j-1];
+    }
+    _rangeStart[j] = bStart;
+    _rangeEnd[j]   = bEnd;
+    _rangeBus[j]   = i;
+  }
+  for (uint8_t j = 1; j < _numRanges; j++) {
+    if (_rangeStart[j] < _rangeEnd[j-1]) { // overlapping busses, pixel may need to be written to more than one bus
+      DEBUG_PRINTLN(F("Overlapping busses, no routing."));
+      _numRanges = 0;
+      return;
+    }
+  }
+
+  // per-pixel table costs 1 byte per LED, only use it if there is plenty of RAM left
+  #ifdef ESP8266
+  if (ESP.getFreeHeap() < totalLen + 8192) return;
+  #else
+  if (ESP.getFreeHeap() < totalLen + 16384) return;
+  #endif
+  _pixelBus = new uint8_t[totalLen];
+  if (!_pixelBus) return; // range search will be used
+  memset(_pixelBus, 0xFF, totalLen);
+  for (uint8_t j = 0; j < _numRanges; j++) memset(_pixelBus + _rangeStart[j], _rangeBus[j], _rangeEnd[j] - _rangeStart[j]);
+  _pixelBusLen = totalLen;
+  DEBUG_PRINTF("Bus routing table: %u bytes\n", totalLen);
+}
+
+// returns index of the bus containing pixel, -1 if none or -2 if routing is not available
+int IRAM_ATTR BusManager::findBus(uint16_t pix) {
+  if (_pixelBus) {
+    if (pix >= _pixelBusLen) return -1;
+    uint8_t b = _pixelBus[pix];
+    return b < numBusses ? b : -1;
+  }
+  if (!_numRanges) return -2;
+  uint8_t lo = 0, hi = _numRanges; // find last range starting at or before pix
+  while (hi - lo > 1) {
+    uint8_t mid = (lo + hi) >> 1;
+    if (_rangeStart[mid] <= pix) lo = mid;
+    else                         hi = mid;
+  }
+  if (pix < _rangeStart[lo] || pix >= _rangeEnd[lo]) return -1;
+  return _rangeBus[lo];
+}
+
+// busses whose pixels and brightness did not change since their last show are skipped
 void BusManager::show() {
+  uint32_t now = millis();
+  if (!_pipelining) {
+    for (uint8_t i = 0; i < numBusses; i++) {
+      Bus *b = busses[i];
+      if (!b->isShowRequired(now)) {
+        b->setSkipped();
+        continue;
+      }
+      uint32_t t0 = micros();
+      b->show();
+      b->getShowTime().add(micros() - t0);
+      b->setShown(now);
+    }
+    return;
+  }
+  // previous frame has to be sent before latched buffers can be reused
+  _worker.wait();
+  _stallUs = _worker.getWaitTime();
+  _latched = 0;
+  for (uint8_t i = 0; i < numBusses; i++) {
+    Bus *b = busses[i];
+    if (!b->isShowRequired(now)) {
+      b->setSkipped();
+      continue;
+    }
+    if (b->latch()) SET_BIT(_latched, i);
+    else { // bus cannot keep a copy of its frame
+      uint32_t t0 = micros();
+      b->show();
+      b->getShowTime().add(micros() - t0);
+    }
+    b->setShown(now);
+  }
+  if (_latched) _worker.post(transmitLatched, this);
+}
+
+// runs on worker task (or inline if there is none)
+void BusManager::transmitLatched(void *manager) {
+  BusManager *bm = static_cast<BusManager*>(manager);
+  for (uint8_t i = 0; i < bm->numBusses; i++) {
+    if (!GET_BIT(bm->_latched, i)) continue;
+    uint32_t t0 = micros();
+    bm->busses[i]->transmit();
+    bm->busses[i]->getShowTime().add(micros() - t0);
+  }
+}
+
+uint16_t BusManager::getMaxFps() {
+  uint32_t frameTime = 0;
   for (uint8_t i = 0; i < numBusses; i++) {
-    busses[i]->show();
+    uint32_t t = busses[i]->getFrameTime(); // busses transmit concurrently (RMT/I2S/UART/DMA), slowest one limits
+    if (t > frameTime) frameTime = t;
   }
+  if (!frameTime) return 0;
+  uint32_t fps = 1000000UL / frameTime;
+  return fps > UINT16_MAX ? UINT16_MAX : fps;
+}
+
+void BusManager::setPipelining(bool enable) {
+  if (enable == _pipelining) return;
+  _worker.wait();
+  if (enable) {
+    // ESP32: send from the core not running loop() (WiFi & async webserver run there too but mostly idle)
+    #ifdef ARDUINO_ARCH_ESP32
+    _worker.begin("busTx", 4096, 1, xPortGetCoreID() ? 0 : 1);
+    #else
+    _worker.begin("busTx");
+    #endif
+  } else {
+    _worker.end();
+  }
+  _pipelining = enable;
 }
 
 void BusManager::setStatusPixel(uint32_t c) {
+  _worker.wait(); // status pixel is written directly into NeoPixelBus
   for (uint8_t i = 0; i < numBusses; i++) {
     busses[i]->setStatusPixel(c);
   }
 }
 
 void IRAM_ATTR BusManager::setPixelColor(uint16_t pix, uint32_t c) {
+  int n = findBus(pix);
+  if (n >= 0) {
+    Bus* b = busses[n];
+    b->setPixelColor(pix - b->getStart(), c);
+    return;
+  }
+  if (n == -1) return; // pixel does not belong to any bus
+  // no routing (overlapping busses), pixel may belong to several busses
   for (uint8_t i = 0; i < numBusses; i++) {
     Bus* b = busses[i];
     uint16_t bstart = b->getStart();
@@ -587,7 +941,22 @@ void IRAM_ATTR BusManager::setPixelColor(uint16_t pix, uint32_t c) {
   }
 }
 
+void BusManager::setPixelColors(uint16_t pix, uint16_t count, const uint32_t *c) {
+  uint32_t end = pix + count;
+  for (uint8_t i = 0; i < numBusses; i++) {
+    Bus* b = busses[i];
+    uint32_t bstart = b->getStart();
+    uint32_t bend   = bstart + b->getLength();
+    uint32_t from   = bstart > pix ? bstart : pix;
+    uint32_t to     = bend < end ? bend : end;
+    if (from >= to) continue;
+    b->setPixelColors(from - bstart, to - from, c + (from - pix));
+  }
+}
+
 void BusManager::setBrightness(uint8_t b) {
+  if (b && !_bri) _worker.wait(); // turning on may re-init bus (LED_BUILTIN)
+  _bri = b;
   for (uint8_t i = 0; i < numBusses; i++) {
     busses[i]->setBrightness(b);
   }
@@ -603,6 +972,9 @@ void BusManager::setSegmentCCT(int16_t cct, bool allowWBCorrection) {
 }
 
 uint32_t BusManager::getPixelColor(uint16_t pix) {
+  int n = findBus(pix);
+  if (n >= 0) return busses[n]->getPixelColor(pix - busses[n]->getStart());
+  if (n == -1) return 0;
   for (uint8_t i = 0; i < numBusses; i++) {
     Bus* b = busses[i];
     uint16_t bstart = b->getStart();
@@ -613,6 +985,7 @@ uint32_t BusManager::getPixelColor(uint16_t pix) {
 }
 
 bool BusManager::canAllShow() {
+  if (_worker.isBusy()) return false;
   for (uint8_t i = 0; i < numBusses; i++) {
     if (!busses[i]->canShow()) return false;
   }
@@ -6,6 +6,8 @@
  */
 
 #include "const.h"
+#include "task_worker.h"
+#include "timing_stat.h"
 
 #define GET_BIT(var,bit)    (((var)>>(bit))&0x01)
 #define SET_BIT(var,bit)    ((var)|=(uint16_t)(0x0001<<(bit)))
@@ -112,7 +114,12 @@ class Bus {
     , _reversed(reversed)
     , _valid(false)
     , _needsRefresh(refresh)
+    , _dirty(true)
+    , _shownBri(0)
     , _data(nullptr) // keep data access consistent across all types of buses
+    , _milliAmps(0)
+    , _lastShow(0)
+    , _skipped(0)
     {
       _autoWhiteMode = Bus::hasWhite(_type) ? aw : RGBW_MODE_MANUAL_ONLY;
     };
@@ -120,9 +127,12 @@ class Bus {
     virtual ~Bus() {} //throw the bus under the bus
 
     virtual void     show() = 0;
+    virtual bool     latch()                     { return false; } // captures frame for transmit() (pipelining); false if bus must be shown synchronously
+    virtual void     transmit()                  {}                // sends latched frame, may run on worker task
     virtual bool     canShow()                   { return true; }
     virtual void     setStatusPixel(uint32_t c)  {}
     virtual void     setPixelColor(uint16_t pix, uint32_t c) = 0;
+    virtual void     setPixelColors(uint16_t pix, uint16_t count, const uint32_t *c) { for (uint16_t i = 0; i < count; i++) setPixelColor(pix + i, c[i]); }
     virtual uint32_t getPixelColor(uint16_t pix) { return 0; }
     virtual void     setBrightness(uint8_t b)    { _bri = b; };
     virtual void     cleanup() = 0;
@@ -132,6 +142,12 @@ class Bus {
     virtual uint8_t  getColorOrder()             { return COL_ORDER_RGB; }
     virtual uint8_t  skippedLeds()               { return 0; }
     virtual uint16_t getFrequency()              { return 0U; }
+    virtual uint32_t getFrameTime()              { return 0U; } // us needed to send one frame (0: negligible or unknown)
+    virtual bool     getPowerSums(uint32_t &sum, uint32_t &max3) { return false; } // channel sums for ABL if maintained by bus
+    virtual uint16_t getKeepAlive()              { return 0U; } // ms after which an unchanged frame is sent again (0: never)
+    inline  void     setUsedCurrent(uint16_t mA) { _milliAmps = mA; }
+    inline  uint16_t getUsedCurrent()            { return _milliAmps; }
+    inline  TimingStat &getShowTime()            { return _showTime; } // show() or transmit() duration
     inline  void     setReversed(bool reversed)  { _reversed = reversed; }
     inline  uint16_t getStart()                  { return _start; }
     inline  void     setStart(uint16_t start)    { _start = start; }
@@ -139,6 +155,16 @@ class Bus {
     inline  bool     isOk()                      { return _valid; }
     inline  bool     isReversed()                { return _reversed; }
     inline  bool     isOffRefreshRequired()      { return _needsRefresh; }
+    inline  void     markDirty()                 { _dirty = true; }
+    inline  uint32_t getSkippedFrames()          { return _skipped; } // show() calls skipped because frame was unchanged
+    // frame has to be sent if pixels or brightness changed since last show, if bus needs periodic refresh or keep-alive is due
+    inline  bool     isShowRequired(uint32_t now) {
+      if (_dirty || _bri != _shownBri || _needsRefresh) return true;
+      uint16_t keepAlive = getKeepAlive();
+      return keepAlive && now - _lastShow >= keepAlive;
+    }
+    inline  void     setShown(uint32_t now)      { _dirty = false; _shownBri = _bri; _lastShow = now; }
+    inline  void     setSkipped()                { _skipped++; }
             bool     containsPixel(uint16_t pix) { return pix >= _start && pix < _start+_len; }
 
     virtual bool hasRGB(void) { return Bus::hasRGB(_type); }
@@ -183,8 +209,14 @@ class Bus {
     bool     _reversed;
     bool     _valid;
     bool     _needsRefresh;
+    bool     _dirty;    // pixel data changed since last show
+    uint8_t  _shownBri; // brightness of last shown frame
     uint8_t  _autoWhiteMode;
     uint8_t  *_data;
+    uint16_t _milliAmps; // estimated current draw (set by ABL)
+    uint32_t _lastShow;  // millis() of last show
+    uint32_t _skipped;
+    TimingStat _showTime;
     static uint8_t _gAWM;
     static int16_t _cct;
     static uint8_t _cctBlend;
@@ -201,16 +233,21 @@ class BusDigital : public Bus {
     ~BusDigital() { cleanup(); }
 
     void show();
+    bool latch();
+    void transmit();
     bool canShow();
     void setBrightness(uint8_t b);
     void setStatusPixel(uint32_t c);
     void setPixelColor(uint16_t pix, uint32_t c);
+    void setPixelColors(uint16_t pix, uint16_t count, const uint32_t *c);
     void setColorOrder(uint8_t colorOrder);
     uint32_t getPixelColor(uint16_t pix);
     uint8_t  getColorOrder() { return _colorOrder; }
     uint8_t  getPins(uint8_t* pinArray);
     uint8_t  skippedLeds()   { return _skip; }
     uint16_t getFrequency()  { return _frequencykHz; }
+    uint32_t getFrameTime();
+    bool getPowerSums(uint32_t &sum, uint32_t &max3);
     void reinit();
     void cleanup();
 
@@ -223,6 +260,14 @@ class BusDigital : public Bus {
     void * _busPtr;
     const ColorOrderMap &_colorOrderMap;
     bool _buffering; // temporary until we figure out why comparison "_data != nullptr" causes severe FPS drop
+    uint32_t _powerSum;  // sum of all channel values in _data, maintained on write (buffering only)
+    uint32_t _powerMax3; // sum of 3*max(R,G,B) of all pixels in _data (WS2815 power model)
+    uint8_t *_dataTx;    // copy of _data latched for transmit() (pipelining only)
+    uint8_t  _briTx;     // brightness latched for transmit()
+    ColorOrderMap _colorOrderMapTx; // color order map latched for transmit(), may be updated while worker runs
+
+    void updatePowerSums(size_t offset, uint32_t c);
+    void transferPixels(const uint8_t *data, uint8_t bri, const ColorOrderMap &com); // writes buffered pixels into NeoPixelBus
 
     inline uint32_t restoreColorLossy(uint32_t c, uint8_t restoreBri) {
       if (restoreBri < 255) {
@@ -280,30 +325,46 @@ class BusOnOff : public Bus {
 
 class BusNetwork : public Bus {
   public:
-    BusNetwork(BusConfig &bc);
+    BusNetwork(BusConfig &bc, uint16_t universeOffset = 0);
     ~BusNetwork() { cleanup(); }
 
     bool hasRGB()   { return true; }
     bool hasWhite() { return _rgbw; }
     bool canShow()  { return !_broadcastLock; } // this should be a return value from UDP routine if it is still sending data out
+    uint16_t getKeepAlive() { return 1000U; } // receivers leave realtime mode if no data arrives (WLED default timeout 2.5s)
     void setPixelColor(uint16_t pix, uint32_t c);
+    void setPixelColors(uint16_t pix, uint16_t count, const uint32_t *c);
     uint32_t getPixelColor(uint16_t pix);
     uint8_t  getPins(uint8_t* pinArray);
+    uint16_t getUniverseCount() { return _UDPtype ? (_len * _UDPchannels - 1) / (_rgbw ? 512 : 510) + 1 : 0; } // E1.31/Art-Net universes per frame
     void show();
+    bool latch();
+    void transmit();
     void cleanup();
 
   private:
     IPAddress _client;
     uint8_t   _UDPtype;
     uint8_t   _UDPchannels;
+    uint16_t  _universeOffset; // E1.31/Art-Net: universes used by busses of the same protocol added before this one
     bool      _rgbw;
     bool      _broadcastLock;
+    uint8_t  *_dataTx; // copy of _data latched for transmit() (pipelining only)
+    uint8_t   _briTx;
+    uint8_t  *_packets;    // DDP only: bitmask of packets changed since last send, followed by mask being sent
+    uint8_t   _packetsLen; // bytes per mask
+    uint8_t  *_packetsTx;  // mask for transmit(), nullptr: complete frame
+    uint8_t   _briSent;
+    uint32_t  _lastKeyframe;
+
+    inline void markPacket(size_t offset) { if (_packets) { size_t p = offset / DDP_CHANNELS_PER_PACKET; _packets[p >> 3] |= 1 << (p & 7); } }
+    uint8_t *takePackets(uint8_t bri);
 };
 
 
 class BusManager {
   public:
-    BusManager() : numBusses(0) {};
+    BusManager() : numBusses(0), _pixelBus(nullptr), _pixelBusLen(0), _numRanges(0), _pipelining(false), _latched(0), _bri(255), _stallUs(0) {};
 
     //utility to get the approx. memory usage of a given BusConfig
     static uint32_t memUsage(BusConfig &bc);
@@ -317,17 +378,30 @@ class BusManager {
     bool canAllShow();
     void setStatusPixel(uint32_t c);
     void setPixelColor(uint16_t pix, uint32_t c);
+    void setPixelColors(uint16_t pix, uint16_t count, const uint32_t *c); // sets count consecutive pixels
     void setBrightness(uint8_t b);
     void setSegmentCCT(int16_t cct, bool allowWBCorrection = false);
     uint32_t getPixelColor(uint16_t pix);
 
     Bus* getBus(uint8_t busNr);
 
+    //builds pixel to bus routing, call once all busses have been added
+    void buildRouting();
+    inline size_t getRoutingSize() const { return _pixelBusLen; }
+
     //semi-duplicate of strip.getLengthTotal() (though that just returns strip._length, calculated in finalizeInit())
     uint16_t getTotalLength();
     inline uint8_t getNumBusses() const { return numBusses; }
+    uint16_t getMaxFps(); // refresh rate limit imposed by slowest bus (0: no limit)
 
-    inline void                 updateColorOrderMap(const ColorOrderMap &com) { memcpy(&colorOrderMap, &com, sizeof(ColorOrderMap)); }
+    // pipelining: busses that can latch their frame are transmitted by a worker task while the next frame is rendered
+    void setPipelining(bool enable);
+    inline bool     isPipelining() const    { return _pipelining; }
+    inline bool     isTransmitting() const  { return _worker.isBusy(); }
+    inline uint32_t getTransmitTime() const { return _worker.getJobTime(); } // us spent sending last frame (overlapped with rendering)
+    inline uint32_t getStallTime() const    { return _stallUs; }             // us show() had to wait for previous frame
+
+    inline void                 updateColorOrderMap(const ColorOrderMap &com) { memcpy(&colorOrderMap, &com, sizeof(ColorOrderMap)); for (uint8_t i = 0; i < numBusses; i++) busses[i]->markDirty(); }
     inline const ColorOrderMap& getColorOrderMap() const { return colorOrderMap; }
 
   private:
@@ -335,6 +409,25 @@ class BusManager {
     Bus* busses[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];
     ColorOrderMap colorOrderMap;
 
+    // pixel to bus routing: per-pixel bus index table (O(1)) if there is enough RAM,
+    // otherwise sorted bus ranges (binary search); linear scan if busses overlap or routing is not built
+    uint8_t  *_pixelBus;
+    uint16_t  _pixelBusLen;
+    uint8_t   _numRanges;
+    uint16_t  _rangeStart[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];
+    uint16_t  _rangeEnd[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];
+    uint8_t   _rangeBus[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];
+
+    TaskWorker _worker;
+    bool       _pipelining;
+    uint16_t   _latched;   // bitmask of busses transmitted by worker
+    uint8_t    _bri;
+    uint32_t   _stallUs;
+
+    void freeRouting();
+    int  findBus(uint16_t pix);
+    static void transmitLatched(void *manager);
+
     inline uint8_t getNumVirtualBusses() {
       int j = 0;
       for (int i=0; i<numBusses; i++) if (busses[i]->getType() >= TYPE_NET_DDP_RGB && busses[i]->getType() < 96) j++;
@@ -91,6 +91,11 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   Bus::setCCTBlend(strip.cctBlending);
   strip.setTargetFps(hw_led["fps"]); //NOP if 0, default 42 FPS
   CJSON(useGlobalLedBuffer, hw_led[F("ld")]);
+  CJSON(strip.useSegmentBuffers, hw_led[F("sb")]);
+  CJSON(strip.usePipelining, hw_led[F("pipe")]);
+  CJSON(strip.parallelRendering, hw_led[F("pr")]);
+  CJSON(idleSleep, hw_led[F("idle")]);
+  CJSON(strip.frameBudget, hw_led[F("fb")]);
 
   #ifndef WLED_DISABLE_2D
   // 2D Matrix Settings
@@ -426,11 +431,28 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   if (e131Priority > 200) e131Priority = 200;
   CJSON(DMXMode, if_live_dmx["mode"]);
 
+  JsonObject if_live_out = if_live["out"]; // E1.31 network busses
+  CJSON(e131OutUniverse, if_live_out[F("uni")]);
+  if (!e131OutUniverse || e131OutUniverse > 63999) e131OutUniverse = 1;
+  CJSON(e131OutPriority, if_live_out[F("prio")]);
+  if (e131OutPriority > 200) e131OutPriority = 200;
+  CJSON(e131OutSyncUniverse, if_live_out[F("sync")]);
+  if (e131OutSyncUniverse > 63999) e131OutSyncUniverse = 0;
+
   tdd = if_live[F("timeout")] | -1;
   if (tdd >= 0) realtimeTimeoutMs = tdd * 100;
   CJSON(arlsForceMaxBri, if_live[F("maxbri")]);
   CJSON(arlsDisableGammaCorrection, if_live[F("no-gc")]); // false
   CJSON(arlsOffset, if_live[F("offset")]); // 0
+  CJSON(udpDrainBudgetUs, if_live[F("drain")]); // 2000
+  CJSON(realtimeRxTask, if_live[F("rxtask")]); // false
+  CJSON(realtimeJitterFrames, if_live[F("jbuf")]); // 0
+  if (realtimeJitterFrames > 8) realtimeJitterFrames = 8;
+  CJSON(realtimeJitterLatency, if_live[F("jlat")]); // 0
+  if (realtimeJitterLatency > 1000) realtimeJitterLatency = 1000;
+  CJSON(ddpIdMode, if_live[F("ddpid")]); // 0
+  if (ddpIdMode > DDP_ID_MODE_BUS) ddpIdMode = DDP_ID_MODE_STRIP;
+  if (udpDrainBudgetUs > 20000) udpDrainBudgetUs = 20000;
 
   CJSON(alexaEnabled, interfaces["va"][F("alexa")]); // false
 
@@ -717,6 +739,11 @@ void serializeConfig() {
   hw_led["fps"] = strip.getTargetFps();
   hw_led[F("rgbwm")] = Bus::getGlobalAWMode(); // global auto white mode override
   hw_led[F("ld")] = useGlobalLedBuffer;
+  hw_led[F("sb")] = strip.useSegmentBuffers;
+  hw_led[F("pipe")] = strip.usePipelining;
+  hw_led[F("pr")] = strip.parallelRendering;
+  hw_led[F("idle")] = idleSleep;
+  hw_led[F("fb")] = strip.frameBudget;
 
   #ifndef WLED_DISABLE_2D
   // 2D Matrix Settings
@@ -883,10 +910,20 @@ void serializeConfig() {
   if_live_dmx[F("dss")] = DMXSegmentSpacing;
   if_live_dmx["mode"] = DMXMode;
 
+  JsonObject if_live_out = if_live.createNestedObject("out");
+  if_live_out[F("uni")] = e131OutUniverse;
+  if_live_out[F("prio")] = e131OutPriority;
+  if_live_out[F("sync")] = e131OutSyncUniverse;
+
   if_live[F("timeout")] = realtimeTimeoutMs / 100;
   if_live[F("maxbri")] = arlsForceMaxBri;
   if_live[F("no-gc")] = arlsDisableGammaCorrection;
   if_live[F("offset")] = arlsOffset;
+  if_live[F("drain")] = udpDrainBudgetUs;
+  if_live[F("rxtask")] = realtimeRxTask;
+  if_live[F("jbuf")] = realtimeJitterFrames;
+  if_live[F("jlat")] = realtimeJitterLatency;
+  if_live[F("ddpid")] = ddpIdMode;
 
   JsonObject if_va = interfaces.createNestedObject("va");
   if_va[F("alexa")] = alexaEnabled;
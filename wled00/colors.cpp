@@ -49,6 +49,55 @@ uint32_t color_add(uint32_t c1, uint32_t c2)
   else           return RGBW32(r * 255 / max, g * 255 / max, b * 255 / max, w * 255 / max);
 }
 
+/*
+ * span (bulk) operations on runs of RGBW32 pixels (i.e. segment framebuffer)
+ * stride allows processing columns of a 2D framebuffer
+ */
+void color_fill_span(uint32_t *px, size_t len, uint32_t c)
+{
+  while (len--) *px++ = c;
+}
+
+// same as CRGB::nscale8() on each pixel (white channel is dropped as with CRGB)
+void color_scale_span(uint32_t *px, size_t len, size_t stride, uint8_t scale)
+{
+  for (; len; len--, px += stride) *px = color_scale8x4(*px, scale) & 0x00FFFFFFU;
+}
+
+// copies len channel bytes (i.e. into a network packet), same as scale8() on each byte, 4 bytes at a time
+void color_scale_bytes(uint8_t *dst, const uint8_t *src, size_t len, uint8_t scale)
+{
+  if (scale == 255) {
+    memcpy(dst, src, len);
+    return;
+  }
+  for (; len >= 4; len -= 4, src += 4, dst += 4) {
+    uint32_t c;
+    memcpy(&c, src, 4); // packet payload is not word aligned
+    c = color_scale8x4(c, scale);
+    memcpy(dst, &c, 4);
+  }
+  while (len--) *dst++ = scale8(*src++, scale);
+}
+
+// same as FastLED blur1d() on CRGB pixels (used by Segment::blur(), blurRow() & blurCol())
+void color_blur_span(uint32_t *px, size_t len, size_t stride, uint8_t blur_amount)
+{
+  uint8_t keep = 255 - blur_amount;
+  uint8_t seep = blur_amount >> 1;
+  uint32_t carryover = 0;
+  uint32_t *prev = nullptr;
+  for (; len; len--, px += stride) {
+    uint32_t before = *px & 0x00FFFFFFU;
+    uint32_t part   = color_scale8x4(before, seep);
+    uint32_t cur    = color_qadd8x4(color_scale8x4(before, keep), carryover);
+    if (prev) *prev = color_qadd8x4(*prev & 0x00FFFFFFU, part);
+    if (before != cur) *px = cur; // only set pixel if color has changed
+    carryover = part;
+    prev = px;
+  }
+}
+
 void setRandomColor(byte* rgb)
 {
   lastRandomIndex = strip.getMainSegment().get_random_wheel_index(lastRandomIndex);
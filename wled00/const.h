@@ -255,6 +255,14 @@
 #define TYPE_NET_ARTNET_RGB      82            //network ArtNet RGB bus (master broadcast bus, unused)
 #define TYPE_NET_DDP_RGBW        88            //network DDP RGBW bus (master broadcast bus)
 
+#define DDP_CHANNELS_PER_PACKET  1440          //480 RGB or 360 RGBW leds per DDP packet
+#define DDP_KEYFRAME_INTERVAL    1000          //ms, network busses send complete frame at least this often (only changed packets otherwise)
+
+//DDP receive: what custom destination IDs (2-245) are routed to
+#define DDP_ID_MODE_STRIP        0             //all IDs feed the whole strip
+#define DDP_ID_MODE_SEGMENT      1             //ID n feeds segment n-2
+#define DDP_ID_MODE_BUS          2             //ID n feeds bus n-2
+
 #define IS_DIGITAL(t) ((t) & 0x10) //digital are 16-31 and 48-63
 #define IS_PWM(t)     ((t) > 40 && (t) < 46)
 #define NUM_PWM_PINS(t) ((t) - 40) //for analog PWM 41-45 only
@@ -1,4 +1,7 @@
 #include "wled.h"
+#ifdef ARDUINO_ARCH_ESP32
+  #include "frame_ring.h"
+#endif
 
 #define MAX_3_CH_LEDS_PER_UNIVERSE 170
 #define MAX_4_CH_LEDS_PER_UNIVERSE 128
@@ -8,8 +11,347 @@
  * E1.31 handler
  */
 
+// frame synchronization: universes of a multi-universe frame are staged and applied together once
+// the E1.31 synchronization / ArtSync packet arrives (or, without sync, the last universe of the frame)
+#define E131_STAGE_SLOT_SIZE (MAX_CHANNELS_PER_UNIVERSE + 1) // E1.31 data is preceded by start code
+#define ARTNET_SYNC_TIMEOUT  4000 // ms, Art-Net nodes return to immediate output if ArtSync stops
+
+static uint8_t      *e131Stage = nullptr;   // E131_STAGE_SLOT_SIZE bytes per universe
+static uint8_t       e131StageSlots = 0;    // universes making up a complete frame
+static uint16_t      e131StageLen[E131_MAX_UNIVERSE_COUNT];
+static uint32_t      e131StageMask = 0;     // bit n set: universe e131Universe+n is staged
+static byte          e131StageProtocol = P_E131;
+static uint8_t       e131StageMode = REALTIME_MODE_E131;
+static uint16_t      e131SyncAddress = 0;   // synchronization universe announced in E1.31 data packets (0: none)
+static unsigned long artSyncTime = 0;       // last ArtSync received
+
+static bool applyE131Universe(uint16_t uni, uint16_t dmxChannels, uint8_t* e131_data, byte protocol, uint8_t mde);
+
+#ifdef ARDUINO_ARCH_ESP32
+// realtime receive task (realtimeRxTask): the AsyncUDP callback only queues packets, which are decoded on a
+// dedicated task into whole strip frames; the main loop shows the newest complete frame.
+// Pixel data and realtime mode entry (realtimeLock()) reach the strip from the main loop only. Main segment only and
+// DMX effect/segment modes still change segments from the receive task, as they do from the AsyncUDP task without it.
+// Both queues have exactly one producer and one consumer (AsyncUDP dispatches all sockets from a single task).
+#define RT_RX_PACKET_SLOTS 8
+#define RT_RX_FRAME_SLOTS  3 // + realtimeJitterFrames
+#define RT_RX_MAX_GAP      1000000 // us between frames after which the sender is considered to have restarted
+#define RT_RX_TASK_STACK   6144
+
+typedef struct {
+  e131_packet_t packet;
+  uint32_t      clientIP;
+  byte          protocol;
+} rt_rx_packet_t;
+
+typedef struct {
+  uint16_t start; // pixels written since the receive task was started
+  uint16_t count;
+  uint32_t time;  // micros() when frame was completed
+  uint32_t seq;
+  uint32_t timecode; // DDP timecode (1/65536 s) of the frame's packets, valid if hasTimecode
+  uint8_t  hasTimecode;
+  uint8_t  reserved[3];
+} rt_rx_frame_t;    // followed by uint32_t pixel colors of the whole strip
+
+static FrameRing    rtRxPackets;
+static FrameRing    rtRxFrames;
+static TaskHandle_t rtRxTaskHandle = nullptr;
+static uint16_t     rtRxFrameLen = 0;           // pixels per frame
+static uint16_t     rtRxLo = UINT16_MAX;        // span of pixels written so far
+static uint16_t     rtRxHi = 0;
+static bool         rtRxFrameDirty = false;     // pixels written since last complete frame
+static bool         rtRxFrameReady = false;     // decoded packet completed the frame
+static uint32_t     rtRxFrameSeq = 0;
+static uint32_t     rtRxTimecode = 0;           // DDP timecode of the frame being decoded
+static bool         rtRxHasTimecode = false;
+
+// realtimeLock() requested while decoding: entering realtime mode clears the strip, freezes segments and sets brightness,
+// so it is done by the main loop (handleRealtimeRxFrames()) instead of the receive task
+static std::atomic<bool>     rtRxLockPending(false);
+static std::atomic<uint32_t> rtRxLockTimeout(0);
+static std::atomic<uint8_t>  rtRxLockMode(0);
+
+// jitter buffer (realtimeJitterFrames > 0): frames are shown at the sender's cadence, delayed by the buffer depth
+static bool         jbRunning = false;
+static uint32_t     jbSeq = 0;                  // frame currently scheduled
+static bool         jbTimecode = false;         // sender timeline is DDP timecode (otherwise frame arrival)
+static uint32_t     jbPrevSender = 0;
+static uint32_t     jbExpected = 0;             // smoothed arrival time of scheduled frame (follows sender clock)
+static uint32_t     jbInterval = 0;             // sender frame interval (us), 0 until known
+static uint32_t     jbDue = 0;                  // presentation time of scheduled frame
+
+static inline uint32_t *rtRxFramePixels(uint8_t *slot) { return (uint32_t*)(slot + sizeof(rt_rx_frame_t)); }
+
+// length of valid data in a packet passed to handleE131Packet()
+static size_t getE131PacketLength(const e131_packet_t* p, byte protocol) {
+  size_t len;
+  if (protocol == P_DDP) {
+    len = (p->data - p->raw) + ((p->flags & DDP_TIMECODE_FLAG) ? 4 : 0) + htons(p->dataLen);
+  } else if (protocol == P_ARTNET) {
+    len = (p->art_opcode == ARTNET_OPCODE_OPDMX) ? (p->art_data - p->raw) + htons(p->art_length) : 14;
+  } else if (htonl(p->root_vector) == E131_VECTOR_ROOT_EXTENDED) {
+    len = 49; // synchronization packet
+  } else {
+    len = (p->property_values - p->raw) + htons(p->property_value_count);
+  }
+  return len < sizeof(e131_packet_t) ? len : sizeof(e131_packet_t);
+}
+
+// AsyncUDP task: hands packet over to the receive task
+static void queueRealtimeRxPacket(e131_packet_t* p, IPAddress clientIP, byte protocol) {
+  rt_rx_packet_t *slot = (rt_rx_packet_t*) rtRxPackets.writeSlot();
+  size_t len = getE131PacketLength(p, protocol);
+  memcpy(&slot->packet, p, len);
+  slot->clientIP = clientIP;
+  slot->protocol = protocol;
+  if (!rtRxPackets.push(len)) {
+    rtRxPacketsDropped++;
+    return;
+  }
+  xTaskNotifyGive(rtRxTaskHandle);
+}
+
+// receive task: publishes the frame being decoded, the next one starts as its copy (packets may update parts only)
+static void publishRealtimeRxFrame() {
+  uint8_t *slot = rtRxFrames.writeSlot();
+  rt_rx_frame_t *frame = (rt_rx_frame_t*) slot;
+  frame->start = rtRxLo;
+  frame->count = rtRxHi - rtRxLo;
+  frame->time  = micros();
+  frame->seq   = ++rtRxFrameSeq;
+  frame->timecode    = rtRxTimecode;
+  frame->hasTimecode = rtRxHasTimecode;
+  if (!rtRxFrames.push(sizeof(rt_rx_frame_t) + rtRxHi * sizeof(uint32_t))) {
+    rtRxFramesSkipped++; // main loop is behind, keep decoding into this frame
+    return;
+  }
+  rtRxFrameDirty = false;
+  rtRxHasTimecode = false;
+  uint8_t *next = rtRxFrames.writeSlot();
+  memcpy(next, slot, sizeof(rt_rx_frame_t));
+  memcpy(rtRxFramePixels(next) + rtRxLo, rtRxFramePixels(slot) + rtRxLo, (rtRxHi - rtRxLo) * sizeof(uint32_t));
+}
+
+static void realtimeRxLoop(void*) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    rt_rx_packet_t *pkt;
+    while ((pkt = (rt_rx_packet_t*) rtRxPackets.front())) {
+      handleE131Packet(&pkt->packet, IPAddress(pkt->clientIP), pkt->protocol);
+      rtRxPackets.pop();
+      if (rtRxFrameReady) {
+        rtRxFrameReady = false;
+        publishRealtimeRxFrame();
+      }
+    }
+  }
+}
+
+// starts the receive task if enabled, frames are sized for the strip length at the time of the first start
+void realtimeRxBegin() {
+  if (!(realtimeRxTask || realtimeJitterFrames) || rtRxTaskHandle) return;
+  rtRxFrameLen = strip.getLengthTotal();
+  if (!rtRxFrameLen
+   || !rtRxPackets.begin(RT_RX_PACKET_SLOTS, sizeof(rt_rx_packet_t))
+   || !rtRxFrames.begin(RT_RX_FRAME_SLOTS + realtimeJitterFrames, sizeof(rt_rx_frame_t) + rtRxFrameLen * sizeof(uint32_t))
+   || xTaskCreatePinnedToCore(realtimeRxLoop, "rtRx", RT_RX_TASK_STACK, nullptr, 2, &rtRxTaskHandle, tskNO_AFFINITY) != pdPASS) {
+    rtRxPackets.end(); // not enough RAM, packets are decoded by the AsyncUDP task
+    rtRxFrames.end();
+    rtRxTaskHandle = nullptr;
+    DEBUG_PRINTLN(F("Realtime receive task not started."));
+  }
+}
+
+static void showRealtimeRxFrame(uint8_t *slot) {
+  rt_rx_frame_t *frame = (rt_rx_frame_t*) slot;
+  if (realtimeMode && !realtimeOverride) {
+    strip.setPixelColors(frame->start, frame->count, rtRxFramePixels(slot) + frame->start);
+    strip.show();
+  }
+  rtRxFrames.pop();
+}
+
+// schedules a frame seen for the first time: its arrival is compared to the sender cadence
+// (late/early count jitter of more than half an interval) and it is due one buffer depth after expected arrival
+// frames with DDP timecode are spaced exactly as stamped by the sender, only the clock offset is smoothed
+static void scheduleRealtimeRxFrame(const rt_rx_frame_t *frame) {
+  uint32_t arrival = frame->time;
+  uint32_t sender = frame->hasTimecode ? (uint32_t)(((uint64_t)frame->timecode * 15625) >> 10) : arrival; // 1/65536 s to us
+  uint32_t delta = sender - jbPrevSender;
+  jbSeq = frame->seq;
+  jbPrevSender = sender;
+  if (!jbRunning || delta > RT_RX_MAX_GAP || jbTimecode != (bool)frame->hasTimecode) { // (re)start, frame is shown right away
+    jbRunning = true;
+    jbTimecode = frame->hasTimecode;
+    jbExpected = arrival;
+  } else if (!jbInterval) { // second frame: first interval measurement
+    jbInterval = delta;
+    jbExpected = arrival;
+  } else {
+    jbInterval += ((int32_t)delta - (int32_t)jbInterval) / 8;
+    jbExpected += jbTimecode ? delta : jbInterval;
+    int32_t err = arrival - jbExpected;
+    if      (err >  (int32_t)jbInterval / 2) rtJitterLate++;
+    else if (err < -(int32_t)jbInterval / 2) rtJitterEarly++;
+    if (abs(err) > 4 * (int32_t)jbInterval) jbExpected = arrival; // lost track, resynchronize
+    else                                     jbExpected += err / 16;
+  }
+  jbDue = jbExpected + realtimeJitterFrames * jbInterval + realtimeJitterLatency * 1000UL;
+}
+
+// main loop: without jitter buffer shows the newest decoded frame (older ones are skipped),
+// with jitter buffer shows frames in order when due, dropping those more than an interval behind
+void handleRealtimeRxFrames() {
+  if (!rtRxTaskHandle) return;
+  if (rtRxLockPending.exchange(false, std::memory_order_acquire)) {
+    realtimeLock(rtRxLockTimeout.load(std::memory_order_relaxed), rtRxLockMode.load(std::memory_order_relaxed));
+  }
+  if (!rtRxFrames.size()) return;
+  if (!realtimeJitterFrames) {
+    if (millis() - strip.getLastShow() <= 15) return;
+    while (rtRxFrames.size() > 1) {
+      rtRxFrames.pop();
+      rtRxFramesSkipped++;
+    }
+    showRealtimeRxFrame(rtRxFrames.front());
+    return;
+  }
+  uint8_t *slot;
+  while ((slot = rtRxFrames.front())) {
+    const rt_rx_frame_t *frame = (const rt_rx_frame_t*) slot;
+    if (frame->seq != jbSeq) scheduleRealtimeRxFrame(frame);
+    int32_t wait = jbDue - micros();
+    if (wait > 0) return;
+    if (jbInterval && -wait > (int32_t)jbInterval && rtRxFrames.size() > 1) { // behind by more than a frame, next one is waiting
+      rtRxFrames.pop();
+      rtRxFramesSkipped++;
+      continue;
+    }
+    showRealtimeRxFrame(slot);
+    return;
+  }
+}
+
+// setRealtimePixel(s)() on the receive task write to the frame instead of the strip
+bool realtimeRxSetPixels(uint16_t pix, uint16_t count, const uint32_t *c) {
+  if (!rtRxTaskHandle || useMainSegmentOnly || xTaskGetCurrentTaskHandle() != rtRxTaskHandle) return false;
+  if (pix >= rtRxFrameLen) return true;
+  if (count > rtRxFrameLen - pix) count = rtRxFrameLen - pix;
+  memcpy(rtRxFramePixels(rtRxFrames.writeSlot()) + pix, c, count * sizeof(uint32_t));
+  if (pix < rtRxLo) rtRxLo = pix;
+  if (pix + count > rtRxHi) rtRxHi = pix + count;
+  rtRxFrameDirty = true;
+  return true;
+}
+
+// realtimeLock() on the receive task only records the request, the main loop applies the latest one
+bool realtimeRxDeferLock(uint32_t timeoutMs, byte md) {
+  if (!rtRxTaskHandle || xTaskGetCurrentTaskHandle() != rtRxTaskHandle) return false;
+  rtRxLockTimeout.store(timeoutMs, std::memory_order_relaxed);
+  rtRxLockMode.store(md, std::memory_order_relaxed);
+  rtRxLockPending.store(true, std::memory_order_release);
+  return true;
+}
+#else
+void realtimeRxBegin() {}
+void handleRealtimeRxFrames() {}
+bool realtimeRxSetPixels(uint16_t pix, uint16_t count, const uint32_t *c) { return false; }
+bool realtimeRxDeferLock(uint32_t timeoutMs, byte md) { return false; }
+#endif
+
+// decoded data has to be shown
+static void setE131NewData() {
+  #ifdef ARDUINO_ARCH_ESP32
+  if (rtRxFrameDirty && xTaskGetCurrentTaskHandle() == rtRxTaskHandle) { // pixels went to the frame ring
+    rtRxFrameReady = true;
+    return;
+  }
+  #endif
+  e131NewData = true;
+}
+
+// number of universes needed for pixel data of the whole strip in DMX_MODE_MULTIPLE_* modes
+static uint8_t getPixelUniverseCount() {
+  bool is4Chan = (DMXMode == DMX_MODE_MULTIPLE_RGBW);
+  const uint16_t dmxChannelsPerLed = is4Chan ? 4 : 3;
+  const uint16_t dimmerOffset = (DMXMode == DMX_MODE_MULTIPLE_DRGB) ? 1 : 0;
+  const uint16_t dmxLenOffset = (DMXAddress == 0) ? 0 : 1; // For legacy DMX start address 0
+  const uint16_t ledsInFirstUniverse = (((MAX_CHANNELS_PER_UNIVERSE - DMXAddress) + dmxLenOffset) - dimmerOffset) / dmxChannelsPerLed;
+  const uint16_t totalLen = strip.getLengthTotal();
+  if (totalLen <= ledsInFirstUniverse) return 1;
+  const uint16_t ledsPerUniverse = is4Chan ? MAX_4_CH_LEDS_PER_UNIVERSE : MAX_3_CH_LEDS_PER_UNIVERSE;
+  uint16_t count = 1 + (totalLen - ledsInFirstUniverse + ledsPerUniverse - 1) / ledsPerUniverse;
+  return count > E131_MAX_UNIVERSE_COUNT ? E131_MAX_UNIVERSE_COUNT : count;
+}
+
+// applies staged universes at once, missedSync: next frame started before sync packet arrived
+static void presentE131Frame(bool missedSync = false) {
+  if (!e131StageMask) return;
+  if (missedSync || e131StageMask != (1UL << e131StageSlots) - 1) e131IncompleteFrames++;
+  e131StagedFrames++;
+  bool newData = false;
+  for (uint8_t n = 0; n < e131StageSlots; n++) {
+    if (!(e131StageMask & (1UL << n))) continue; // missing universe keeps previous pixels
+    newData |= applyE131Universe(e131Universe + n, e131StageLen[n], e131Stage + n * E131_STAGE_SLOT_SIZE, e131StageProtocol, e131StageMode);
+  }
+  e131StageMask = 0;
+  if (newData) setE131NewData();
+}
+
+// returns true if universe was staged (or dropped), false if it has to be applied right away
+static bool stageE131Universe(uint16_t uni, uint16_t dmxChannels, const uint8_t* e131_data, byte protocol, uint8_t mde, bool sync) {
+  if (DMXMode != DMX_MODE_MULTIPLE_RGB && DMXMode != DMX_MODE_MULTIPLE_DRGB && DMXMode != DMX_MODE_MULTIPLE_RGBW) return false;
+  uint8_t count = getPixelUniverseCount();
+  if (count < 2 && !sync) { // single universe is a complete frame
+    e131StageMask = 0;
+    return false;
+  }
+  if (count != e131StageSlots || !e131Stage) {
+    free(e131Stage);
+    e131Stage = (uint8_t*) malloc(count * E131_STAGE_SLOT_SIZE);
+    e131StageSlots = e131Stage ? count : 0;
+    e131StageMask = 0;
+    if (!e131Stage) return false; // not enough RAM, fall back to immediate output
+  }
+
+  uint8_t n = uni - e131Universe;
+  if (n >= e131StageSlots) return true; // no LEDs left for this universe
+  if (protocol != e131StageProtocol) e131StageMask = 0; // sender changed
+  if (e131StageMask & (1UL << n)) presentE131Frame(sync); // universe repeats, previous frame will not be completed
+
+  size_t len = dmxChannels + (protocol == P_E131); // E1.31 data includes start code
+  if (len > E131_STAGE_SLOT_SIZE) len = E131_STAGE_SLOT_SIZE;
+  memcpy(e131Stage + n * E131_STAGE_SLOT_SIZE, e131_data, len);
+  e131StageLen[n] = len - (protocol == P_E131);
+  e131StageMask |= 1UL << n;
+  e131StageProtocol = protocol;
+  e131StageMode = mde;
+
+  if (!sync && e131StageMask == (1UL << e131StageSlots) - 1) presentE131Frame(); // last expected universe arrived
+  return true;
+}
+
+// pixel range fed by a custom DDP destination ID (ddpIdMode), false if there is no such output
+static bool getDDPOutput(uint8_t id, uint16_t &start, uint16_t &len) {
+  uint8_t n = id - (DDP_ID_DISPLAY + 1);
+  if (ddpIdMode == DDP_ID_MODE_SEGMENT) {
+    if (n >= strip.getSegmentsNum()) return false;
+    Segment &seg = strip.getSegment(n);
+    if (!seg.isActive() || seg.usesMatrix()) return false; // 1D segments outside of matrix only
+    start = seg.start;
+    len   = seg.stop - seg.start;
+  } else {
+    Bus *bus = busses.getBus(n);
+    if (!bus) return false;
+    start = bus->getStart();
+    len   = bus->getLength();
+  }
+  return true;
+}
+
 //DDP protocol support, called by handleE131Packet
-//handles RGB data only
+//handles RGB data only, destination IDs 2-245 may be routed to segments or busses (ddpIdMode)
 void handleDDPPacket(e131_packet_t* p) {
   int lastPushSeq = e131LastSequenceNumber[0];
 
@@ -25,27 +367,43 @@ void handleDDPPacket(e131_packet_t* p) {
     }
   }
 
+  uint8_t id = p->destination;
+  if (id == DDP_ID_CONTROL || id == DDP_ID_CONFIG || id == DDP_ID_STATUS || id == DDP_ID_DMX) return; // no pixel data
+
   uint8_t ddpChannelsPerLed = ((p->dataType & 0b00111000)>>3 == 0b011) ? 4 : 3; // data type 0x1B (formerly 0x1A) is RGBW (type 3, 8 bit/channel)
 
-  uint32_t start =  htonl(p->channelOffset) / ddpChannelsPerLed;
-  start += DMXAddress / ddpChannelsPerLed;
-  uint16_t stop = start + htons(p->dataLen) / ddpChannelsPerLed;
+  uint32_t start = htonl(p->channelOffset) / ddpChannelsPerLed;
+  uint32_t count = htons(p->dataLen) / ddpChannelsPerLed;
+  bool routed = ddpIdMode != DDP_ID_MODE_STRIP && id > DDP_ID_DISPLAY && id < DDP_ID_CONTROL && !useMainSegmentOnly;
+  if (routed) { // clipped to the output, so arlsOffset must not shift it into the next one
+    uint16_t outStart, outLen;
+    if (!getDDPOutput(id, outStart, outLen) || start >= outLen) count = 0;
+    else if (count > outLen - start) count = outLen - start;
+    start += outStart;
+  } else {
+    start += DMXAddress / ddpChannelsPerLed;
+  }
+  if (start > UINT16_MAX) count = 0;
+
   uint8_t* data = p->data;
   uint16_t c = 0;
-  if (p->flags & DDP_TIMECODE_FLAG) c = 4; //packet has timecode flag, we do not support it, but data starts 4 bytes later
+  if (p->flags & DDP_TIMECODE_FLAG) { // presentation time, data starts 4 bytes later
+    #ifdef ARDUINO_ARCH_ESP32
+    rtRxTimecode = (uint32_t(data[0]) << 24) | (uint32_t(data[1]) << 16) | (uint32_t(data[2]) << 8) | data[3];
+    rtRxHasTimecode = true;
+    #endif
+    c = 4;
+  }
 
   realtimeLock(realtimeTimeoutMs, REALTIME_MODE_DDP);
 
   if (!realtimeOverride || (realtimeMode && useMainSegmentOnly)) {
-    for (uint16_t i = start; i < stop; i++) {
-      setRealtimePixel(i, data[c], data[c+1], data[c+2], ddpChannelsPerLed >3 ? data[c+3] : 0);
-      c += ddpChannelsPerLed;
-    }
+    if (count) setRealtimePixels(start, count, data + c, ddpChannelsPerLed, !routed);
   }
 
   bool push = p->flags & DDP_PUSH_FLAG;
   if (push) {
-    e131NewData = true;
+    setE131NewData();
     byte sn = p->sequenceNum & 0xF;
     if (sn) e131LastSequenceNumber[0] = sn;
   }
@@ -53,6 +411,12 @@ void handleDDPPacket(e131_packet_t* p) {
 
 //E1.31 and Art-Net protocol support
 void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
+  #ifdef ARDUINO_ARCH_ESP32
+  if (rtRxTaskHandle && xTaskGetCurrentTaskHandle() != rtRxTaskHandle) {
+    queueRealtimeRxPacket(p, clientIP, protocol);
+    return;
+  }
+  #endif
 
   uint16_t uni = 0, dmxChannels = 0;
   uint8_t* e131_data = nullptr;
@@ -64,12 +428,21 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
       handleArtnetPollReply(clientIP);
       return;
     }
+    if (p->art_opcode == ARTNET_OPCODE_OPSYNC) {
+      artSyncTime = millis(); // node is in synchronous mode while ArtSync keeps arriving
+      presentE131Frame();
+      return;
+    }
     uni = p->art_universe;
     dmxChannels = htons(p->art_length);
     e131_data = p->art_data;
     seq = p->art_sequence_number;
     mde = REALTIME_MODE_ARTNET;
   } else if (protocol == P_E131) {
+    if (htonl(p->root_vector) == E131_VECTOR_ROOT_EXTENDED) { // synchronization packet
+      if (e131SyncAddress && htons(p->sync_universe) == e131SyncAddress) presentE131Frame();
+      return;
+    }
     // Ignore PREVIEW data (E1.31: 6.2.6)
     if ((p->options & 0x80) != 0) return;
     dmxChannels = htons(p->property_value_count) - 1;
@@ -119,6 +492,22 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
 
   // update status info
   realtimeIP = clientIP;
+
+  bool sync;
+  if (protocol == P_ARTNET) {
+    sync = artSyncTime && millis() - artSyncTime < ARTNET_SYNC_TIMEOUT;
+  } else {
+    e131SyncAddress = htons(p->reserved);
+    sync = e131SyncAddress != 0;
+  }
+  if (stageE131Universe(uni, dmxChannels, e131_data, protocol, mde, sync)) return;
+
+  if (applyE131Universe(uni, dmxChannels, e131_data, protocol, mde)) setE131NewData();
+}
+
+// writes DMX data of a universe to LEDs (or segment settings), returns true if LEDs have to be shown
+static bool applyE131Universe(uint16_t uni, uint16_t dmxChannels, uint8_t* e131_data, byte protocol, uint8_t mde) {
+  uint8_t previousUniverses = uni - e131Universe;
   byte wChannel = 0;
   uint16_t totalLen = strip.getLengthTotal();
   uint16_t availDMXLen = 0;
@@ -139,16 +528,16 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
 
   switch (DMXMode) {
     case DMX_MODE_DISABLED:
-      return;  // nothing to do
+      return false;  // nothing to do
       break;
 
     case DMX_MODE_SINGLE_RGB:   // 3 channel: [R,G,B]
-      if (uni != e131Universe) return;
-      if (availDMXLen < 3) return;
+      if (uni != e131Universe) return false;
+      if (availDMXLen < 3) return false;
 
       realtimeLock(realtimeTimeoutMs, mde);
 
-      if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
+      if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return false;
 
       wChannel = (availDMXLen > 3) ? e131_data[dataOffset+3] : 0;
       for (uint16_t i = 0; i < totalLen; i++)
@@ -156,11 +545,11 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
       break;
 
     case DMX_MODE_SINGLE_DRGB:  // 4 channel: [Dimmer,R,G,B]
-      if (uni != e131Universe) return;
-      if (availDMXLen < 4) return;
+      if (uni != e131Universe) return false;
+      if (availDMXLen < 4) return false;
 
       realtimeLock(realtimeTimeoutMs, mde);
-      if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
+      if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return false;
       wChannel = (availDMXLen > 4) ? e131_data[dataOffset+4] : 0;
 
       if (bri != e131_data[dataOffset+0]) {
@@ -174,7 +563,7 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
 
     case DMX_MODE_PRESET:       // 2 channel: [Dimmer,Preset]
       {
-        if (uni != e131Universe || availDMXLen < 2) return;
+        if (uni != e131Universe || availDMXLen < 2) return false;
 
         // limit max. selectable preset to 250, even though DMX max. val is 255
         uint8_t dmxValPreset = (e131_data[dataOffset+1] > 250 ? 250 : e131_data[dataOffset+1]);
@@ -194,7 +583,7 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
           strip.setBrightness(scaledBri(bri), false);
           stateUpdated(CALL_MODE_WS_SEND);
         }
-        return;
+        return false;
         break;
       }
 
@@ -203,7 +592,7 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
     case DMX_MODE_EFFECT_SEGMENT:   // 15 channels per segment;
     case DMX_MODE_EFFECT_SEGMENT_W: // 18 Channels per segment;
       {
-        if (uni != e131Universe) return;
+        if (uni != e131Universe) return false;
         bool isSegmentMode = DMXMode == DMX_MODE_EFFECT_SEGMENT || DMXMode == DMX_MODE_EFFECT_SEGMENT_W;
         uint8_t dmxEffectChannels = (DMXMode == DMX_MODE_EFFECT || DMXMode == DMX_MODE_EFFECT_SEGMENT) ? 15 : 18;
         for (uint8_t id = 0; id < strip.getSegmentsNum(); id++) {
@@ -217,7 +606,7 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
             dataOffset--;
           // Skip out of universe addresses
           if (dataOffset > dmxChannels - dmxEffectChannels + 1)
-            return;
+            return false;
 
           if (e131_data[dataOffset+1] < strip.getModeCount())
             if (e131_data[dataOffset+1] != seg.mode)      seg.setMode(   e131_data[dataOffset+1]);
@@ -255,7 +644,7 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
             }
           }
         }
-        return;
+        return false;
         break;
       }
       
@@ -270,7 +659,7 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
         uint16_t previousLeds, dmxOffset, ledsTotal;
 
         if (previousUniverses == 0) {
-          if (availDMXLen < 1) return;
+          if (availDMXLen < 1) return false;
           dmxOffset = dataOffset;
           previousLeds = 0;
           // First DMX address is dimmer in DMX_MODE_MULTIPLE_DRGB mode.
@@ -291,11 +680,11 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
 
         // All LEDs already have values
         if (previousLeds >= totalLen) {
-          return;
+          return false;
         }
 
         realtimeLock(realtimeTimeoutMs, mde);
-        if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
+        if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return false;
 
         if (ledsTotal > totalLen) {
           ledsTotal = totalLen;
@@ -308,26 +697,16 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
           }
         }
 
-        if (!is4Chan) {
-          for (uint16_t i = previousLeds; i < ledsTotal; i++) {
-            setRealtimePixel(i, e131_data[dmxOffset], e131_data[dmxOffset+1], e131_data[dmxOffset+2], 0);
-            dmxOffset+=3;
-          }
-        } else {
-          for (uint16_t i = previousLeds; i < ledsTotal; i++) {
-            setRealtimePixel(i, e131_data[dmxOffset], e131_data[dmxOffset+1], e131_data[dmxOffset+2], e131_data[dmxOffset+3]);
-            dmxOffset+=4;
-          }
-        }
+        if (ledsTotal > previousLeds) setRealtimePixels(previousLeds, ledsTotal - previousLeds, e131_data + dmxOffset, dmxChannelsPerLed);
         break;
       }
     default:
       DEBUG_PRINTLN(F("unknown E1.31 DMX mode"));
-      return;  // nothing to do
+      return false;  // nothing to do
       break;
   }
 
-  e131NewData = true;
+  return true;
 }
 
 void handleArtnetPollReply(IPAddress ipAddress) {
@@ -354,30 +733,8 @@ void handleArtnetPollReply(IPAddress ipAddress) {
     case DMX_MODE_MULTIPLE_DRGB:
     case DMX_MODE_MULTIPLE_RGB:
     case DMX_MODE_MULTIPLE_RGBW:
-      {
-        bool is4Chan = (DMXMode == DMX_MODE_MULTIPLE_RGBW);
-        const uint16_t dmxChannelsPerLed = is4Chan ? 4 : 3;
-        const uint16_t dimmerOffset = (DMXMode == DMX_MODE_MULTIPLE_DRGB) ? 1 : 0;
-        const uint16_t dmxLenOffset = (DMXAddress == 0) ? 0 : 1; // For legacy DMX start address 0
-        const uint16_t ledsInFirstUniverse = (((MAX_CHANNELS_PER_UNIVERSE - DMXAddress) + dmxLenOffset) - dimmerOffset) / dmxChannelsPerLed;
-        const uint16_t totalLen = strip.getLengthTotal();
-
-        if (totalLen > ledsInFirstUniverse) {
-          const uint16_t ledsPerUniverse = is4Chan ? MAX_4_CH_LEDS_PER_UNIVERSE : MAX_3_CH_LEDS_PER_UNIVERSE;
-          const uint16_t remainLED = totalLen - ledsInFirstUniverse;
-
-          endUniverse += (remainLED / ledsPerUniverse);
-
-          if ((remainLED % ledsPerUniverse) > 0) {
-            endUniverse++;
-          }
-
-          if ((endUniverse - startUniverse) > E131_MAX_UNIVERSE_COUNT) {
-            endUniverse = startUniverse + E131_MAX_UNIVERSE_COUNT - 1;
-          }
-        }
-        break;
-      }
+      endUniverse += getPixelUniverseCount() - 1;
+      break;
     default:
       DEBUG_PRINTLN(F("unknown E1.31 DMX mode"));
       return;  // nothing to do
@@ -64,6 +64,20 @@ class NeoGammaWLEDMethod {
 #define gamma8(c)  NeoGammaWLEDMethod::rawGamma8(c)
 uint32_t color_blend(uint32_t,uint32_t,uint16_t,bool b16=false);
 uint32_t color_add(uint32_t,uint32_t);
+// SWAR helpers, all 4 channels of RGBW32 color are processed at once
+inline uint32_t color_scale8x4(uint32_t c, uint8_t scale) { // same as scale8() on each channel
+  uint32_t s = scale + 1;
+  return ((((c & 0x00FF00FFU) * s) >> 8) & 0x00FF00FFU) | ((((c >> 8) & 0x00FF00FFU) * s) & 0xFF00FF00U);
+}
+inline uint32_t color_qadd8x4(uint32_t a, uint32_t b) { // same as qadd8() on each channel
+  uint32_t t = (a & 0x7F7F7F7FU) + (b & 0x7F7F7F7FU);
+  uint32_t c = ((a & b) | ((a ^ b) & t)) & 0x80808080U; // carry out of each channel
+  return (t ^ ((a ^ b) & 0x80808080U)) | ((c >> 7) * 0xFFU);
+}
+void color_fill_span(uint32_t *px, size_t len, uint32_t c);
+void color_scale_span(uint32_t *px, size_t len, size_t stride, uint8_t scale);
+void color_scale_bytes(uint8_t *dst, const uint8_t *src, size_t len, uint8_t scale);
+void color_blur_span(uint32_t *px, size_t len, size_t stride, uint8_t blur_amount);
 inline uint32_t colorFromRgbw(byte* rgbw) { return uint32_t((byte(rgbw[3]) << 24) | (byte(rgbw[0]) << 16) | (byte(rgbw[1]) << 8) | (byte(rgbw[2]))); }
 void colorHStoRGB(uint16_t hue, byte sat, byte* rgb); //hue, sat to rgb
 void colorKtoRGB(uint16_t kelvin, byte* rgb);
@@ -82,6 +96,10 @@ void handleDMX();
 
 //e131.cpp
 void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol);
+void realtimeRxBegin();
+void handleRealtimeRxFrames();
+bool realtimeRxSetPixels(uint16_t pix, uint16_t count, const uint32_t *c);
+bool realtimeRxDeferLock(uint32_t timeoutMs, byte md);
 void handleArtnetPollReply(IPAddress ipAddress);
 void prepareArtnetPollReply(ArtPollReply* reply);
 void sendArtnetPollReply(ArtPollReply* reply, IPAddress ipAddress, uint16_t portAddress);
@@ -227,11 +245,12 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply=tru
 
 //udp.cpp
 void notify(byte callMode, bool followUp=false);
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri=255, bool isRGBW=false);
+uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri=255, bool isRGBW=false, const uint8_t *packetMask=nullptr, uint16_t universeOffset=0);
 void realtimeLock(uint32_t timeoutMs, byte md = REALTIME_MODE_GENERIC);
 void exitRealtime();
 void handleNotifications();
 void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w);
+void setRealtimePixels(uint16_t start, uint16_t count, const uint8_t *data, uint8_t channelsPerPixel, bool applyOffset = true);
 void refreshNodeList();
 void sendSysInfoUDP();
 
@@ -0,0 +1,95 @@
+#ifndef WLED_FRAME_RING_H
+#define WLED_FRAME_RING_H
+/*
+ * Lock-free single-producer/single-consumer ring of fixed size slots (i.e. received packets or decoded frames)
+ * - producer fills writeSlot() and hands it to the consumer with push(); the slot it writes is never visible
+ *   to the consumer, so if push() fails (ring full) the slot keeps its content and may be pushed later
+ * - consumer reads front() and returns the slot with pop()
+ * - only the head (written by producer) and tail (written by consumer) indices are shared
+ * Uses std::atomic only, so it builds (and can be stress-tested with threads) on the host as well.
+ * begin() and end() must not be called while producer or consumer are active.
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <atomic>
+
+class FrameRing {
+  public:
+    FrameRing() : _buf(nullptr), _len(nullptr), _slots(0), _slotSize(0), _head(0), _tail(0) {}
+    ~FrameRing() { end(); }
+
+    // slots: number of slots including the one owned by the producer (min. 2)
+    bool begin(uint8_t slots, size_t slotSize) {
+      end();
+      if (slots < 2 || !slotSize) return false;
+      _buf = (uint8_t*) calloc(slots, slotSize);
+      _len = (size_t*)  calloc(slots, sizeof(size_t));
+      if (!_buf || !_len) { end(); return false; }
+      _slots    = slots;
+      _slotSize = slotSize;
+      _head.store(0, std::memory_order_relaxed);
+      _tail.store(0, std::memory_order_relaxed);
+      return true;
+    }
+
+    void end(void) {
+      free(_buf);
+      free(_len);
+      _buf = nullptr;
+      _len = nullptr;
+      _slots = 0;
+      _slotSize = 0;
+    }
+
+    inline bool    isReady(void)  const { return _buf != nullptr; }
+    inline size_t  slotSize(void) const { return _slotSize; }
+    inline uint8_t capacity(void) const { return _slots ? _slots - 1 : 0; } // slots the consumer can have pending
+
+    // producer: slot currently being filled
+    inline uint8_t *writeSlot(void) const { return _buf + _head.load(std::memory_order_relaxed) * _slotSize; }
+
+    // producer: publishes writeSlot() with len bytes of content, false if ring is full
+    bool push(size_t len) {
+      uint8_t head = _head.load(std::memory_order_relaxed);
+      uint8_t next = next_(head);
+      if (next == _tail.load(std::memory_order_acquire)) return false;
+      _len[head] = len;
+      _head.store(next, std::memory_order_release);
+      return true;
+    }
+
+    // consumer: number of published slots not yet popped
+    uint8_t size(void) const {
+      uint8_t head = _head.load(std::memory_order_acquire);
+      uint8_t tail = _tail.load(std::memory_order_relaxed);
+      return head >= tail ? head - tail : head + _slots - tail;
+    }
+
+    // consumer: oldest published slot (owned by consumer until pop()), nullptr if empty
+    uint8_t *front(size_t *len = nullptr) const {
+      uint8_t tail = _tail.load(std::memory_order_relaxed);
+      if (tail == _head.load(std::memory_order_acquire)) return nullptr;
+      if (len) *len = _len[tail];
+      return _buf + tail * _slotSize;
+    }
+
+    // consumer: returns oldest slot to the producer
+    void pop(void) {
+      uint8_t tail = _tail.load(std::memory_order_relaxed);
+      if (tail == _head.load(std::memory_order_acquire)) return;
+      _tail.store(next_(tail), std::memory_order_release);
+    }
+
+  private:
+    uint8_t *_buf;
+    size_t  *_len;
+    uint8_t  _slots;
+    size_t   _slotSize;
+    std::atomic<uint8_t> _head; // slot being written by producer
+    std::atomic<uint8_t> _tail; // oldest slot not yet popped by consumer
+
+    inline uint8_t next_(uint8_t i) const { return i + 1 == _slots ? 0 : i + 1; }
+};
+
+#endif
@@ -10,6 +10,7 @@
 #define JSON_PATH_FXDATA     6
 #define JSON_PATH_NETWORKS   7
 #define JSON_PATH_EFFECTS    8
+#define JSON_PATH_BENCH      9
 
 /*
  * JSON API (De)serialization
@@ -453,6 +454,10 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
     else callMode = CALL_MODE_DIRECT_CHANGE;  // possible bugfix for playlist only containing HTTP API preset FX=~
   }
 
+  // effect benchmark {"n":frames,"l":layouts}, frames 0 aborts, max. 255 (results on /json/bench)
+  JsonObject bench = root[F("bench")];
+  if (!bench.isNull()) strip.requestBenchmark(constrain(bench["n"] | 20, 0, 255), bench["l"] | 0);
+
   if (root.containsKey(F("rmcpal")) && root[F("rmcpal")].as<bool>()) {
     if (strip.customPalettes.size()) {
       char fileName[32];
@@ -596,6 +601,14 @@ void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segme
   }
 }
 
+// [last, avg, max] in us
+static void serializeTiming(JsonArray arr, const TimingStat &t)
+{
+  arr.add(t.getLast());
+  arr.add(t.getAvg());
+  arr.add(t.getMax());
+}
+
 void serializeInfo(JsonObject root)
 {
   root[F("ver")] = versionString;
@@ -606,8 +619,61 @@ void serializeInfo(JsonObject root)
   leds[F("count")] = strip.getLengthTotal();
   leds[F("pwr")] = strip.currentMilliamps;
   leds["fps"] = strip.getFps();
+  leds[F("tfps")] = strip.getTargetFps();
+  leds[F("maxfps")] = busses.getMaxFps(); // limit imposed by bus protocol & length (0 = none)
   leds[F("maxpwr")] = (strip.currentMilliamps)? strip.ablMilliampsMax : 0;
+  if (strip.currentMilliamps) {
+    JsonArray bpwr = leds.createNestedArray(F("bpwr")); // estimated current per bus (0 for non-digital)
+    for (uint8_t b = 0; b < busses.getNumBusses(); b++) bpwr.add(busses.getBus(b)->getUsedCurrent());
+  }
+  JsonArray bskip = leds.createNestedArray(F("bskip")); // frames not sent per bus because nothing changed
+  for (uint8_t b = 0; b < busses.getNumBusses(); b++) bskip.add(busses.getBus(b)->getSkippedFrames());
   leds[F("maxseg")] = strip.getMaxSegments();
+  if (strip.useSegmentBuffers) leds[F("segbuf")] = strip.getSegmentBuffersSize(); // RAM used by segment framebuffers
+  leds[F("segmap")] = strip.getSegmentMapsSize(); // RAM used by precomputed segment geometry
+  if (busses.isPipelining()) {
+    JsonObject pipe = leds.createNestedObject(F("pipe"));
+    pipe[F("tx")]    = busses.getTransmitTime(); // us sending last frame, overlapped with rendering
+    pipe[F("stall")] = busses.getStallTime();    // us show() waited for previous frame
+  }
+  #ifdef WLED_ENABLE_SEGMENT_ARENA
+  JsonObject arena = leds.createNestedObject(F("arena")); // segment data arena statistics
+  arena[F("free")] = Segment::getDataArena().getFree();
+  arena[F("lfb")]  = Segment::getDataArena().getLargestFree();
+  arena[F("frag")] = Segment::getDataArena().getFragmentation();
+  arena[F("cmp")]  = Segment::getDataArena().getCompactions();
+  #endif
+
+  // frame time diagnostics (us)
+  JsonObject tm = root.createNestedObject("tm");
+  serializeTiming(tm.createNestedArray(F("loop")),  loopTime);
+  serializeTiming(tm.createNestedArray(F("net")),   netTime);
+  serializeTiming(tm.createNestedArray(F("um")),    usermodTime);
+  serializeTiming(tm.createNestedArray(F("ps")),    presetTime);
+  serializeTiming(tm.createNestedArray(F("strip")), stripTime);
+  serializeTiming(tm.createNestedArray(F("abl")),   strip.getAblTime());
+  serializeTiming(tm.createNestedArray(F("frame")), strip.getFrameInterval()); // time between shows
+  serializeTiming(tm.createNestedArray(F("jit")),   strip.getFrameJitter());   // deviation from target frame time
+  serializeTiming(tm.createNestedArray(F("pass")),  strip.getPassTime());      // effects + show() per frame
+
+  // frame rate governor decisions
+  JsonObject gov = tm.createNestedObject(F("gov"));
+  gov[F("bud")]  = strip.frameBudget;            // ms, 0 = governor off
+  gov[F("idle")] = strip.isSkippingIdleRefresh(); // frozen & solid segments do not force frames
+  JsonArray thr = gov.createNestedArray(F("thr")); // frames skipped between renders, per segment
+  for (size_t s = 0; s < strip.getSegmentsNum(); s++) thr.add(strip.getSegment(s).getThrottle());
+  JsonArray tmBus = tm.createNestedArray(F("bus")); // show() or transmit() per bus
+  for (uint8_t b = 0; b < busses.getNumBusses(); b++) serializeTiming(tmBus.createNestedArray(), busses.getBus(b)->getShowTime());
+  JsonArray tmSeg = tm.createNestedArray(F("seg")); // effect function per active segment
+  for (size_t s = 0; s < strip.getSegmentsNum(); s++) {
+    Segment &sg = strip.getSegment(s);
+    if (!sg.isActive()) continue;
+    JsonObject t = tmSeg.createNestedObject();
+    t["id"] = s;
+    t["fx"] = sg.mode;
+    serializeTiming(t.createNestedArray("t"), sg.getEffectTime());
+  }
+
   //leds[F("actseg")] = strip.getActiveSegmentsNum();
   //leds[F("seglock")] = false; //might be used in the future to prevent modifications to segment config
 
@@ -670,6 +736,27 @@ void serializeInfo(JsonObject root)
   } else {
     root[F("lip")] = realtimeIP.toString();
   }
+  if (e131StagedFrames) {
+    JsonArray lfr = root.createNestedArray(F("lfr")); // multi-universe/synchronized DMX frames: applied, incomplete
+    lfr.add(e131StagedFrames);
+    lfr.add(e131IncompleteFrames);
+  }
+  JsonArray urx = root.createNestedArray(F("urx")); // notifier/realtime UDP packets: received, malformed, handled in last loop pass, max handled per loop pass, passes cut short by drain budget
+  urx.add(udpPacketsReceived);
+  urx.add(udpPacketsMalformed);
+  urx.add(udpPacketsPerLoop);
+  urx.add(udpPacketsPerLoopMax);
+  urx.add(udpDrainBudgetExits);
+  if (realtimeRxTask || realtimeJitterFrames) {
+    JsonArray rxt = root.createNestedArray(F("rxt")); // realtime receive task: packets dropped, frames skipped
+    rxt.add(rtRxPacketsDropped);
+    rxt.add(rtRxFramesSkipped);
+  }
+  if (realtimeJitterFrames) {
+    JsonArray jb = root.createNestedArray(F("jb")); // jitter buffer: frames late, early (dropped frames are in "rxt")
+    jb.add(rtJitterLate);
+    jb.add(rtJitterEarly);
+  }
 
   #ifdef WLED_ENABLE_WEBSOCKETS
   root[F("ws")] = ws.count();
@@ -954,6 +1041,49 @@ void serializeNetworks(JsonObject root)
   }
 }
 
+// benchmark status and layouts; with layout >= 0 also per effect results (us per frame, ns per pixel)
+void serializeBenchmark(JsonObject root, int layout)
+{
+  root["n"]          = strip.getBenchmarkFrames();
+  root[F("run")]     = strip.isBenchmarking();
+  root[F("prog")]    = strip.getBenchmarkProgress();   // percent
+  root[F("fxcount")] = strip.getModeCount();
+
+  JsonArray layouts = root.createNestedArray(F("layouts"));
+  for (int i = 0; i < BENCH_LAYOUT_COUNT; i++) {
+    uint16_t w, h;
+    bool gm;
+    WS2812FX::getBenchmarkLayout(i, w, h, gm);
+    JsonObject l = layouts.createNestedObject();
+    l["w"]      = w;
+    l["h"]      = h;
+    l["gm"]     = gm; // grouping 2 + mirror
+    l["px"]     = WS2812FX::getBenchmarkPixels(i);
+    l[F("req")] = bool(strip.getBenchmarkLayouts() & (1U << i));
+  }
+
+  if (layout < 0 || layout >= BENCH_LAYOUT_COUNT) return;
+  // one layout per request to fit JSON buffer, null for skipped effects
+  root["l"] = layout;
+  uint16_t px = WS2812FX::getBenchmarkPixels(layout);
+  JsonArray mean = root.createNestedArray(F("mean"));
+  JsonArray p99  = root.createNestedArray(F("p99"));
+  JsonArray nspx = root.createNestedArray(F("nspx"));
+  for (int m = 0; m < strip.getModeCount(); m++) {
+    uint16_t us  = strip.getBenchmarkResult(layout, m);
+    uint16_t usP = strip.getBenchmarkResult(layout, m, true);
+    if (us == BENCH_NO_RESULT) {
+      mean.add(nullptr);
+      p99.add(nullptr);
+      nspx.add(nullptr);
+    } else {
+      mean.add(us);
+      p99.add(usP);
+      nspx.add((us * 1000UL) / px);
+    }
+  }
+}
+
 void serializeNodes(JsonObject root)
 {
   JsonArray nodes = root.createNestedArray("nodes");
@@ -1004,7 +1134,8 @@ void serveJson(AsyncWebServerRequest* request)
 {
   byte subJson = 0;
   const String& url = request->url();
-  if      (url.indexOf("state") > 0) subJson = JSON_PATH_STATE;
+  if      (url.indexOf("bench") > 0) subJson = JSON_PATH_BENCH;
+  else if (url.indexOf("state") > 0) subJson = JSON_PATH_STATE;
   else if (url.indexOf("info")  > 0) subJson = JSON_PATH_INFO;
   else if (url.indexOf("si")    > 0) subJson = JSON_PATH_STATE_INFO;
   else if (url.indexOf("nodes") > 0) subJson = JSON_PATH_NODES;
@@ -1054,6 +1185,8 @@ void serveJson(AsyncWebServerRequest* request)
       serializeModeData(lDoc); break;
     case JSON_PATH_NETWORKS:
       serializeNetworks(lDoc); break;
+    case JSON_PATH_BENCH:
+      serializeBenchmark(lDoc, request->hasParam("l") ? request->getParam("l")->value().toInt() : -1); break;
     default: //all
       JsonObject state = lDoc.createNestedObject("state");
       serializeState(state);
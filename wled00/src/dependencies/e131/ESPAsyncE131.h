@@ -53,10 +53,19 @@ typedef struct ip_addr ip4_addr_t;
 #define DDP_PUSH_FLAG 0x01
 #define DDP_TIMECODE_FLAG 0x10
 
+// DDP destination IDs (2-245 are custom outputs)
+#define DDP_ID_DISPLAY 1
+#define DDP_ID_CONTROL 246
+#define DDP_ID_CONFIG 250
+#define DDP_ID_STATUS 251
+#define DDP_ID_DMX 254
+#define DDP_ID_ALL 255
+
 #define DDP_TYPE_RGB24  0x0B // 00 001 011 (RGB , 8 bits per channel, 3 channels)
 #define DDP_TYPE_RGBW32 0x1B // 00 011 011 (RGBW, 8 bits per channel, 4 channels)
 
 #define ARTNET_OPCODE_OPDMX 0x5000
+#define ARTNET_OPCODE_OPSYNC 0x5200
 #define ARTNET_OPCODE_OPPOLL 0x2000
 #define ARTNET_OPCODE_OPPOLLREPLY 0x2100
 
@@ -89,6 +98,10 @@ typedef struct ip_addr ip4_addr_t;
 #define E131_DMP_COUNT 123
 #define E131_DMP_DATA 125
 
+// E1.31 synchronization packet (E1.31-2016: 6.3)
+#define E131_VECTOR_ROOT_EXTENDED 0x00000008
+#define E131_VECTOR_EXTENDED_SYNC 0x00000001
+
 // E1.31 Packet Structure
 typedef union {
     struct { //E1.31 packet
@@ -105,7 +118,7 @@ typedef union {
       uint32_t frame_vector;
       uint8_t  source_name[64];
       uint8_t  priority;
-      uint16_t reserved;
+      uint16_t reserved;        // synchronization address (E1.31-2016), 0 if sender does not synchronize
       uint8_t  sequence_number;
       uint8_t  options;
       uint16_t universe;
@@ -120,6 +133,15 @@ typedef union {
       uint8_t  property_values[513];
     } __attribute__((packed));
 	
+    struct { //E1.31 synchronization packet (root layer same as above)
+      uint8_t  sync_root_layer[38];
+      uint16_t sync_flength;
+      uint32_t sync_vector;
+      uint8_t  sync_sequence_number;
+      uint16_t sync_universe;
+      uint16_t sync_reserved;
+    } __attribute__((packed));
+
 	struct { //Art-Net packet
     uint8_t  art_id[8];
     uint16_t art_opcode;
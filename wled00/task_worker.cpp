@@ -0,0 +1,144 @@
+#include "task_worker.h"
+
+#if defined(WLED_WORKER_STDTHREAD)
+  #include <chrono>
+  static uint32_t workerMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+#else
+  #include <Arduino.h>
+  #define workerMicros() micros()
+#endif
+
+TaskWorker::TaskWorker()
+: _job(nullptr)
+, _arg(nullptr)
+, _busy(false)
+, _pending(false)
+, _running(false)
+, _jobUs(0)
+, _waitUs(0)
+#if defined(WLED_WORKER_FREERTOS)
+, _task(nullptr)
+, _start(nullptr)
+, _done(nullptr)
+#elif defined(WLED_WORKER_STDTHREAD)
+, _quit(false)
+, _hasJob(false)
+, _finished(false)
+#endif
+{}
+
+void TaskWorker::run() {
+  uint32_t t0 = workerMicros();
+  if (_job) _job(_arg);
+  _jobUs = workerMicros() - t0;
+  _busy = false; // set by post(), job is no longer in flight
+}
+
+// without a worker thread (ESP8266 or begin() failed) jobs are executed inline
+bool TaskWorker::begin(const char *name, uint32_t stackSize, uint8_t priority, int8_t core) {
+  if (_running) return true;
+#if defined(WLED_WORKER_FREERTOS)
+  _start = xSemaphoreCreateBinary();
+  _done  = xSemaphoreCreateBinary();
+  if (_start && _done &&
+      xTaskCreatePinnedToCore(taskLoop, name, stackSize, this, priority, &_task, core < 0 ? tskNO_AFFINITY : core) == pdPASS) {
+    _running = true;
+  } else {
+    if (_start) vSemaphoreDelete(_start);
+    if (_done)  vSemaphoreDelete(_done);
+    _start = _done = nullptr;
+  }
+#elif defined(WLED_WORKER_STDTHREAD)
+  _quit = false;
+  _thread = std::thread(&TaskWorker::threadLoop, this);
+  _running = true;
+#endif
+  return _running;
+}
+
+void TaskWorker::end() {
+  wait();
+  if (!_running) return;
+#if defined(WLED_WORKER_FREERTOS)
+  vTaskDelete(_task); // task is blocked waiting for next job
+  vSemaphoreDelete(_start);
+  vSemaphoreDelete(_done);
+  _task  = nullptr;
+  _start = _done = nullptr;
+#elif defined(WLED_WORKER_STDTHREAD)
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _quit = true;
+  }
+  _cv.notify_all();
+  _thread.join();
+#endif
+  _running = false;
+}
+
+void TaskWorker::post(job_t job, void *arg) {
+  wait(); // only one job at a time
+  _job = job;
+  _arg = arg;
+  if (!_running) {
+    _busy = true;
+    run();
+    return;
+  }
+  _pending = true;
+#if defined(WLED_WORKER_FREERTOS)
+  _busy = true; // in flight from now on, even if the task has not been scheduled yet
+  xSemaphoreGive(_start);
+#elif defined(WLED_WORKER_STDTHREAD)
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _busy   = true; // in flight from now on, even if the thread has not woken up yet
+    _hasJob = true;
+  }
+  _cv.notify_all();
+#endif
+}
+
+void TaskWorker::wait() {
+  if (!_pending) {
+    _waitUs = 0;
+    return;
+  }
+  uint32_t t0 = workerMicros();
+#if defined(WLED_WORKER_FREERTOS)
+  xSemaphoreTake(_done, portMAX_DELAY);
+#elif defined(WLED_WORKER_STDTHREAD)
+  std::unique_lock<std::mutex> lock(_mtx);
+  _cv.wait(lock, [this]{ return _finished; });
+  _finished = false;
+#endif
+  _pending = false;
+  _waitUs = workerMicros() - t0;
+}
+
+#if defined(WLED_WORKER_FREERTOS)
+void TaskWorker::taskLoop(void *worker) {
+  TaskWorker *w = static_cast<TaskWorker*>(worker);
+  for (;;) {
+    xSemaphoreTake(w->_start, portMAX_DELAY);
+    w->run();
+    xSemaphoreGive(w->_done);
+  }
+}
+#elif defined(WLED_WORKER_STDTHREAD)
+void TaskWorker::threadLoop() {
+  std::unique_lock<std::mutex> lock(_mtx);
+  for (;;) {
+    _cv.wait(lock, [this]{ return _quit || _hasJob; });
+    if (_quit) return;
+    _hasJob = false;
+    lock.unlock();
+    run();
+    lock.lock();
+    _finished = true;
+    _cv.notify_all();
+  }
+}
+#endif
@@ -0,0 +1,98 @@
+#ifndef WLED_TASK_WORKER_H
+#define WLED_TASK_WORKER_H
+/*
+ * Minimal background worker running one job at a time (i.e. bus transmission while next frame is rendered)
+ * - ESP32: FreeRTOS task (may be pinned to the core not running loop())
+ * - host build (no Arduino): std::thread
+ * - ESP8266: no threads, jobs are run inline from post()
+ * post() and wait() must only be called from a single thread (main loop).
+ */
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined(ARDUINO_ARCH_ESP32)
+  #include <Arduino.h>
+  #define WLED_WORKER_FREERTOS
+#elif !defined(ARDUINO)
+  #include <thread>
+  #include <mutex>
+  #include <condition_variable>
+  #define WLED_WORKER_STDTHREAD
+#endif
+
+class TaskWorker {
+  public:
+    typedef void (*job_t)(void *arg);
+
+    TaskWorker();
+    ~TaskWorker() { end(); }
+
+    bool begin(const char *name, uint32_t stackSize = 4096, uint8_t priority = 1, int8_t core = -1); // core -1: no affinity
+    void end(void);
+    void post(job_t job, void *arg); // runs job asynchronously, waits for previous job first
+    void wait(void);                 // blocks until posted job has finished
+
+    inline bool     isRunning(void) const { return _running; }
+    inline bool     isBusy(void)    const { return _busy; }     // job posted and not yet finished
+    inline uint32_t getJobTime(void)  const { return _jobUs; }  // duration of last job (us)
+    inline uint32_t getWaitTime(void) const { return _waitUs; } // time main loop was blocked in last wait() (us)
+
+  private:
+    job_t             _job;
+    void             *_arg;
+    volatile bool     _busy;    // set by post(), cleared when job has finished
+    bool              _pending; // job posted but not yet waited for
+    bool              _running;
+    volatile uint32_t _jobUs;
+    uint32_t          _waitUs;
+
+    void run(void); // executes posted job and signals completion
+
+  #if defined(WLED_WORKER_FREERTOS)
+    TaskHandle_t      _task;
+    SemaphoreHandle_t _start;
+    SemaphoreHandle_t _done;
+    static void taskLoop(void *worker);
+  #elif defined(WLED_WORKER_STDTHREAD)
+    std::thread             _thread;
+    std::mutex              _mtx;
+    std::condition_variable _cv;
+    bool                    _quit;
+    bool                    _hasJob;
+    bool                    _finished;
+    void threadLoop(void);
+  #endif
+};
+
+/*
+ * Recursive mutex guarding data shared by concurrently running tasks (no-op without worker threads)
+ */
+class TaskMutex {
+  public:
+  #if defined(WLED_WORKER_FREERTOS)
+    TaskMutex() : _mtx(xSemaphoreCreateRecursiveMutex()) {}
+    inline void lock(void)   { xSemaphoreTakeRecursive(_mtx, portMAX_DELAY); }
+    inline void unlock(void) { xSemaphoreGiveRecursive(_mtx); }
+  private:
+    SemaphoreHandle_t _mtx;
+  #elif defined(WLED_WORKER_STDTHREAD)
+    inline void lock(void)   { _mtx.lock(); }
+    inline void unlock(void) { _mtx.unlock(); }
+  private:
+    std::recursive_mutex _mtx;
+  #else
+    inline void lock(void)   {}
+    inline void unlock(void) {}
+  #endif
+};
+
+// locks mutex for the lifetime of the object
+class TaskLock {
+  public:
+    explicit TaskLock(TaskMutex &m) : _m(m) { _m.lock(); }
+    ~TaskLock() { _m.unlock(); }
+  private:
+    TaskMutex &_m;
+};
+
+#endif
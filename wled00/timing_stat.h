@@ -0,0 +1,36 @@
+#ifndef WLED_TIMING_STAT_H
+#define WLED_TIMING_STAT_H
+/*
+ * Low overhead duration statistics (microseconds), cheap enough to be always enabled
+ * - last: most recent sample
+ * - avg:  exponential moving average over ~16 samples
+ * - max:  largest sample within the current and previous window of 256 samples
+ */
+#include <stdint.h>
+
+class TimingStat {
+  public:
+    TimingStat() { reset(); }
+
+    inline void add(uint32_t us) {
+      _last = us;
+      _acc  = _acc ? _acc - (_acc >> 4) + us : us << 4; // first sample seeds the average
+      if (us > _max)  _max  = us;
+      if (us > _peak) _peak = us;
+      if (++_n == 0) { _max = _peak; _peak = 0; } // window of 256 samples elapsed
+    }
+    inline void reset(void) { _last = _acc = _max = _peak = 0; _n = 0; }
+
+    inline uint32_t getLast(void) const { return _last; }
+    inline uint32_t getAvg(void)  const { return _acc >> 4; }
+    inline uint32_t getMax(void)  const { return _max; }
+
+  private:
+    uint32_t _last;
+    uint32_t _acc;  // average * 16
+    uint32_t _max;  // max of current & previous window
+    uint32_t _peak; // max of current window
+    uint8_t  _n;
+};
+
+#endif
@@ -1,4 +1,7 @@
 #include "wled.h"
+#ifdef ARDUINO_ARCH_ESP32
+#include <lwip/sockets.h>
+#endif
 
 /*
  * UDP sync notifier / Realtime / Hyperion / TPM2.NET
@@ -151,6 +154,7 @@ void notify(byte callMode, bool followUp)
 
 void realtimeLock(uint32_t timeoutMs, byte md)
 {
+  if (realtimeRxDeferLock(timeoutMs, md)) return; // called on realtime receive task, main loop will apply it
   if (!realtimeMode && !realtimeOverride) {
     uint16_t stop, start;
     if (useMainSegmentOnly) {
@@ -210,15 +214,17 @@ void sendTPM2Ack() {
 }
 
 
+static bool handleUdpPacket();
+static bool udpShowPending = false; // realtime data received during the current drain pass
+
 void handleNotifications()
 {
-  IPAddress localIP;
-
   //send second notification if enabled
   if(udpConnected && (notificationCount < udpNumRetries) && ((millis()-notificationSentTime) > 250)){
     notify(notificationSentCallMode,true);
   }
 
+  handleRealtimeRxFrames();
   if (e131NewData && millis() - strip.getLastShow() > 15)
   {
     e131NewData = false;
@@ -231,6 +237,31 @@ void handleNotifications()
   //receive UDP notifications
   if (!udpConnected) return;
 
+  // drain pending packets until all sockets are empty or the time budget is used up
+  // realtime frames are shown once after draining so that a backlog is not pushed to the LEDs frame by frame
+  unsigned long drainStart = micros();
+  uint16_t handled = 0;
+  while (handleUdpPacket()) {
+    handled++;
+    if (micros() - drainStart >= udpDrainBudgetUs) {
+      udpDrainBudgetExits++; // more packets may still be pending
+      break;
+    }
+  }
+  udpPacketsReceived += handled;
+  udpPacketsPerLoop = handled;
+  if (handled > udpPacketsPerLoopMax) udpPacketsPerLoopMax = handled;
+  if (udpShowPending) {
+    udpShowPending = false;
+    strip.show();
+  }
+}
+
+// receives and handles a single packet from the notifier or raw RGB sockets, returns false if none was pending
+static bool handleUdpPacket()
+{
+  IPAddress localIP;
+
   bool isSupp = false;
   size_t packetSize = notifierUdp.parsePacket();
   if (!packetSize && udp2Connected) {
@@ -242,32 +273,27 @@ void handleNotifications()
   if (!packetSize && udpRgbConnected) {
     packetSize = rgbUdp.parsePacket();
     if (packetSize) {
-      if (!receiveDirect) return;
-      if (packetSize > UDP_IN_MAXSIZE || packetSize < 3) return;
+      if (!receiveDirect) return true;
+      if (packetSize > UDP_IN_MAXSIZE || packetSize < 3) { udpPacketsMalformed++; return true; }
       realtimeIP = rgbUdp.remoteIP();
       DEBUG_PRINTLN(rgbUdp.remoteIP());
       uint8_t lbuf[packetSize];
       rgbUdp.read(lbuf, packetSize);
       realtimeLock(realtimeTimeoutMs, REALTIME_MODE_HYPERION);
-      if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
-      uint16_t id = 0;
-      uint16_t totalLen = strip.getLengthTotal();
-      for (size_t i = 0; i < packetSize -2; i += 3)
-      {
-        setRealtimePixel(id, lbuf[i], lbuf[i+1], lbuf[i+2], 0);
-        id++; if (id >= totalLen) break;
-      }
-      if (!(realtimeMode && useMainSegmentOnly)) strip.show();
-      return;
+      if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return true;
+      setRealtimePixels(0, packetSize/3, lbuf, 3);
+      if (!(realtimeMode && useMainSegmentOnly)) udpShowPending = true;
+      return true;
     }
   }
 
-  if (!(receiveNotifications || receiveDirect)) return;
+  if (!packetSize) return false;
+  if (!(receiveNotifications || receiveDirect)) return true;
 
   localIP = Network.localIP();
   //notifier and UDP realtime
-  if (!packetSize || packetSize > UDP_IN_MAXSIZE) return;
-  if (!isSupp && notifierUdp.remoteIP() == localIP) return; //don't process broadcasts we send ourselves
+  if (packetSize > UDP_IN_MAXSIZE) { udpPacketsMalformed++; return true; }
+  if (!isSupp && notifierUdp.remoteIP() == localIP) return true; //don't process broadcasts we send ourselves
 
   uint8_t udpIn[packetSize +1];
   uint16_t len;
@@ -276,7 +302,7 @@ void handleNotifications()
 
   // WLED nodes info notifications
   if (isSupp && udpIn[0] == 255 && udpIn[1] == 1 && len >= 40) {
-    if (!nodeListEnabled || notifier2Udp.remoteIP() == localIP) return;
+    if (!nodeListEnabled || notifier2Udp.remoteIP() == localIP) return true;
 
     uint8_t unit = udpIn[39];
     NodesMap::iterator it = Nodes.find(unit);
@@ -302,15 +328,15 @@ void handleNotifications()
           build |= udpIn[40+i]<<(8*i);
       it->second.build = build;
     }
-    return;
+    return true;
   }
 
   //wled notifier, ignore if realtime packets active
   if (udpIn[0] == 0 && !realtimeMode && receiveNotifications)
   {
     //ignore notification if received within a second after sending a notification ourselves
-    if (millis() - notificationSentTime < 1000) return;
-    if (udpIn[1] > 199) return; //do not receive custom versions
+    if (millis() - notificationSentTime < 1000) return true;
+    if (udpIn[1] > 199) return true; //do not receive custom versions
 
     //compatibilityVersionByte:
     byte version = udpIn[11];
@@ -318,8 +344,8 @@ void handleNotifications()
     // if we are not part of any sync group ignore message
     if (version < 9 || version > 199) {
       // legacy senders are treated as if sending in sync group 1 only
-      if (!(receiveGroups & 0x01)) return;
-    } else if (!(receiveGroups & udpIn[36])) return;
+      if (!(receiveGroups & 0x01)) return true;
+    } else if (!(receiveGroups & udpIn[36])) return true;
 
     bool someSel = (receiveNotificationBrightness || receiveNotificationColor || receiveNotificationEffects);
 
@@ -460,10 +486,10 @@ void handleNotifications()
 
     if (receiveNotificationBrightness || !someSel) bri = udpIn[2];
     stateUpdated(CALL_MODE_NOTIFICATION);
-    return;
+    return true;
   }
 
-  if (!receiveDirect) return;
+  if (!receiveDirect) return true;
 
   //TPM2.NET
   if (udpIn[0] == 0x9c)
@@ -472,13 +498,13 @@ void handleNotifications()
     //if the number of LEDs in your installation doesn't allow that, please include padding bytes at the end of the last packet
     byte tpmType = udpIn[1];
     if (tpmType == 0xaa) { //TPM2.NET polling, expect answer
-      sendTPM2Ack(); return;
+      sendTPM2Ack(); return true;
     }
-    if (tpmType != 0xda) return; //return if notTPM2.NET data
+    if (tpmType != 0xda) return true; //return if notTPM2.NET data
 
     realtimeIP = (isSupp) ? notifier2Udp.remoteIP() : notifierUdp.remoteIP();
     realtimeLock(realtimeTimeoutMs, REALTIME_MODE_TPM2NET);
-    if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
+    if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return true;
 
     tpmPacketCount++; //increment the packet count
     if (tpmPacketCount == 1) tpmPayloadFrameSize = (udpIn[2] << 8) + udpIn[3]; //save frame size for the whole payload if this is the first packet
@@ -499,9 +525,9 @@ void handleNotifications()
     if (tpmPacketCount == numPackets) //reset packet count and show if all packets were received
     {
       tpmPacketCount = 0;
-      strip.show();
+      udpShowPending = true;
     }
-    return;
+    return true;
   }
 
   //UDP realtime: 1 warls 2 drgb 3 drgbw
@@ -509,16 +535,16 @@ void handleNotifications()
   {
     realtimeIP = (isSupp) ? notifier2Udp.remoteIP() : notifierUdp.remoteIP();
     DEBUG_PRINTLN(realtimeIP);
-    if (packetSize < 2) return;
+    if (packetSize < 2) { udpPacketsMalformed++; return true; }
 
     if (udpIn[1] == 0)
     {
       realtimeTimeout = 0;
-      return;
+      return true;
     } else {
       realtimeLock(udpIn[1]*1000 +1, REALTIME_MODE_UDP);
     }
-    if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
+    if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return true;
 
     uint16_t totalLen = strip.getLengthTotal();
     if (udpIn[0] == 1) //warls
@@ -529,43 +555,21 @@ void handleNotifications()
       }
     } else if (udpIn[0] == 2) //drgb
     {
-      uint16_t id = 0;
-      for (size_t i = 2; i < packetSize -2; i += 3)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
-
-        id++; if (id >= totalLen) break;
-      }
+      setRealtimePixels(0, (packetSize - 2) / 3, udpIn + 2, 3);
     } else if (udpIn[0] == 3) //drgbw
     {
-      uint16_t id = 0;
-      for (size_t i = 2; i < packetSize -3; i += 4)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], udpIn[i+3]);
-
-        id++; if (id >= totalLen) break;
-      }
-    } else if (udpIn[0] == 4) //dnrgb
+      setRealtimePixels(0, (packetSize - 2) / 4, udpIn + 2, 4);
+    } else if (udpIn[0] == 4 && packetSize > 4) //dnrgb
     {
       uint16_t id = ((udpIn[3] << 0) & 0xFF) + ((udpIn[2] << 8) & 0xFF00);
-      for (size_t i = 4; i < packetSize -2; i += 3)
-      {
-        if (id >= totalLen) break;
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
-        id++;
-      }
-    } else if (udpIn[0] == 5) //dnrgbw
+      if (id < totalLen) setRealtimePixels(id, (packetSize - 4) / 3, udpIn + 4, 3);
+    } else if (udpIn[0] == 5 && packetSize > 4) //dnrgbw
     {
       uint16_t id = ((udpIn[3] << 0) & 0xFF) + ((udpIn[2] << 8) & 0xFF00);
-      for (size_t i = 4; i < packetSize -2; i += 4)
-      {
-        if (id >= totalLen) break;
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], udpIn[i+3]);
-        id++;
-      }
+      if (id < totalLen) setRealtimePixels(id, (packetSize - 4) / 4, udpIn + 4, 4);
     }
-    strip.show();
-    return;
+    udpShowPending = true;
+    return true;
   }
 
   // API over UDP
@@ -583,6 +587,7 @@ void handleNotifications()
     }
     releaseJSONBufferLock();
   }
+  return true;
 }
 
 
@@ -596,15 +601,53 @@ void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w)
       b = gamma8(b);
       w = gamma8(w);
     }
+    uint32_t col = RGBW32(r, g, b, w);
     if (useMainSegmentOnly) {
       Segment &seg = strip.getMainSegment();
-      if (pix<seg.length()) seg.setPixelColor(pix, r, g, b, w);
-    } else {
-      strip.setPixelColor(pix, r, g, b, w);
+      if (pix<seg.length()) seg.setPixelColor(pix, col);
+    } else if (!realtimeRxSetPixels(pix, 1, &col)) {
+      strip.setPixelColor(pix, col);
     }
   }
 }
 
+// bulk variant of setRealtimePixel() for contiguous runs of RGB (channelsPerPixel 3) or RGBW (4) data
+// colors are gamma corrected into a small stack buffer and handed to the busses a chunk at a time
+// applyOffset false skips arlsOffset for callers that already clipped start/count to a segment or bus
+#define REALTIME_CHUNK_PIXELS 32
+void setRealtimePixels(uint16_t start, uint16_t count, const uint8_t *data, uint8_t channelsPerPixel, bool applyOffset)
+{
+  int pix = start + (applyOffset ? arlsOffset : 0);
+  int totalLen = strip.getLengthTotal();
+  if (pix < 0) { // skip pixels shifted before the start of the strip
+    if (-pix >= count) return;
+    data -= pix * channelsPerPixel;
+    count += pix;
+    pix = 0;
+  }
+  if (pix >= totalLen) return;
+  if (count > totalLen - pix) count = totalLen - pix;
+
+  Segment *seg = useMainSegmentOnly ? &strip.getMainSegment() : nullptr;
+  if (seg && pix + count > seg->length()) count = pix < seg->length() ? seg->length() - pix : 0;
+  const bool gamma = !arlsDisableGammaCorrection && gammaCorrectCol;
+  const bool hasW = channelsPerPixel > 3;
+  uint32_t buf[REALTIME_CHUNK_PIXELS];
+
+  while (count) {
+    uint16_t n = count < REALTIME_CHUNK_PIXELS ? count : REALTIME_CHUNK_PIXELS;
+    for (uint16_t j = 0; j < n; j++, data += channelsPerPixel) {
+      uint8_t w = hasW ? data[3] : 0;
+      buf[j] = gamma ? RGBW32(gamma8(data[0]), gamma8(data[1]), gamma8(data[2]), gamma8(w))
+                     : RGBW32(data[0], data[1], data[2], w);
+    }
+    if (seg) for (uint16_t j = 0; j < n; j++) seg->setPixelColor(pix + j, buf[j]);
+    else if (!realtimeRxSetPixels(pix, n, buf)) strip.setPixelColors(pix, n, buf);
+    pix += n;
+    count -= n;
+  }
+}
+
 /*********************************************************************************************\
    Refresh aging for remote units, drop if too old...
 \*********************************************************************************************/
@@ -698,13 +741,6 @@ void sendSysInfoUDP()
 #define DDP_FLAGS1_STORAGE 0x08
 #define DDP_FLAGS1_TIME 0x10
 
-#define DDP_ID_DISPLAY 1
-#define DDP_ID_CONFIG 250
-#define DDP_ID_STATUS 251
-
-// 1440 channels per packet
-#define DDP_CHANNELS_PER_PACKET 1440 // 480 leds
-
 //
 // Send real time UDP updates to the specified client
 //
@@ -713,15 +749,79 @@ void sendSysInfoUDP()
 // length - the number of pixels
 // buffer - a buffer of at least length*4 bytes long
 // isRGBW - true if the buffer contains 4 components per pixel
+// packetMask - DDP only: bitmask of packets to send (nullptr: all), push flag is set on the last one sent
 
 static       size_t sequenceNumber = 0; // this needs to be shared across all outputs
 static const size_t ART_NET_HEADER_SIZE = 12;
 static const byte   ART_NET_HEADER[] PROGMEM = {0x41,0x72,0x74,0x2d,0x4e,0x65,0x74,0x00,0x00,0x50,0x00,0x0e};
 
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri, bool isRGBW)  {
-  if (!(apActive || interfacesInited) || !client[0] || !length) return 1;  // network not initialised or dummy/unset IP address  031522 ajn added check for ap
+#define E131_HEADER_LEN       (E131_DMP_DATA + 1) // headers and DMX start code
+#define E131_SYNC_PACKET_LEN  49
+#define E131_MAX_OUT_UNIVERSE 63999
+static const byte ACN_PACKET_ID[] PROGMEM = {0x41,0x53,0x43,0x2d,0x45,0x31,0x2e,0x31,0x37,0x00,0x00,0x00}; // "ASC-E1.17"
+static const byte E131_CID_PREFIX[] PROGMEM = {0x57,0x4c,0x45,0x44,0xe1,0x31,0x40,0x00,0x80,0x00}; // "WLED" + fixed bytes, MAC follows
+
+#ifdef ARDUINO_ARCH_ESP32
+static int      rtSendSocket = -1;      // kept between frames (ESP32 WiFiUDP copies packets byte by byte)
+#else
+static WiFiUDP  rtSendUdp;              // kept between frames, a new WiFiUDP would set up a UDP context each time
+#endif
+static uint8_t *ddpPacket    = nullptr; // packet buffers are allocated on first use and kept, payload is scaled into them
+static uint8_t *artnetPacket = nullptr;
+static uint8_t *e131Packet   = nullptr; // E1.31 data packet for one universe
+static uint8_t  e131Sequence = 0;
+static uint8_t  e131SyncSequence = 0;
+
+static inline void writeU16(uint8_t *p, uint16_t v) { p[0] = v >> 8; p[1] = v & 0xFF; } // network byte order
+
+// fills parts of E1.31 data packet that do not change between packets
+static void e131InitPacket(uint8_t *p) {
+  memset(p, 0, E131_HEADER_LEN);
+  writeU16(p + E131_ROOT_PREAMBLE_SIZE, 0x0010);
+  memcpy_P(p + E131_ROOT_ID, ACN_PACKET_ID, sizeof(ACN_PACKET_ID));
+  p[E131_ROOT_VECTOR+3] = 0x04; // VECTOR_ROOT_E131_DATA
+  memcpy_P(p + E131_ROOT_CID, E131_CID_PREFIX, sizeof(E131_CID_PREFIX));
+  WiFi.macAddress(p + E131_ROOT_CID + sizeof(E131_CID_PREFIX)); // CID has to be unique per device
+  p[E131_FRAME_VECTOR+3] = 0x02; // VECTOR_E131_DATA_PACKET
+  p[E131_DMP_VECTOR] = 0x02;     // VECTOR_DMP_SET_PROPERTY
+  p[E131_DMP_TYPE]   = 0xA1;
+  writeU16(p + E131_DMP_ADDR_INC, 1);
+}
+
+// sends prebuilt packet with a single write
+static bool sendPacket(IPAddress client, uint16_t port, const uint8_t *packet, size_t len) {
+#ifdef ARDUINO_ARCH_ESP32
+  if (rtSendSocket < 0) {
+    rtSendSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (rtSendSocket < 0) return false;
+  }
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family      = AF_INET;
+  addr.sin_port        = htons(port);
+  addr.sin_addr.s_addr = (uint32_t)client;
+  if (sendto(rtSendSocket, packet, len, 0, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+    DEBUG_PRINTF("sendto() returned error %d\n", errno);
+    return false;
+  }
+  return true;
+#else
+  if (!rtSendUdp.beginPacket(client, port)) {
+    DEBUG_PRINTLN(F("WiFiUDP.beginPacket returned an error"));
+    return false;
+  }
+  rtSendUdp.write(packet, len);
+  if (!rtSendUdp.endPacket()) {
+    DEBUG_PRINTLN(F("WiFiUDP.endPacket returned an error"));
+    return false;
+  }
+  return true;
+#endif
+}
 
-  WiFiUDP ddpUdp;
+// universeOffset: E1.31/Art-Net universes sent by other busses of the same protocol before this one
+uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri, bool isRGBW, const uint8_t *packetMask, uint16_t universeOffset)  {
+  if (!(apActive || interfacesInited) || !client[0] || !length) return 1;  // network not initialised or dummy/unset IP address  031522 ajn added check for ap
 
   switch (type) {
     case 0: // DDP
@@ -730,66 +830,116 @@ uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8
       size_t channelCount = length * (isRGBW? 4:3); // 1 channel for every R,G,B value
       size_t packetCount = ((channelCount-1) / DDP_CHANNELS_PER_PACKET) +1;
 
-      // there are 3 channels per RGB pixel
-      uint32_t channel = 0; // TODO: allow specifying the start channel
-      // the current position in the buffer
-      size_t bufferOffset = 0;
+      // last packet to send carries the push flag
+      size_t lastPacket = packetCount - 1;
+      if (packetMask) {
+        while (!(packetMask[lastPacket >> 3] & (1 << (lastPacket & 7)))) {
+          if (lastPacket-- == 0) return 0; // nothing changed
+        }
+      }
 
-      for (size_t currentPacket = 0; currentPacket < packetCount; currentPacket++) {
-        if (sequenceNumber > 15) sequenceNumber = 0;
+      if (!ddpPacket) {
+        ddpPacket = (uint8_t*) malloc(DDP_HEADER_LEN + DDP_CHANNELS_PER_PACKET);
+        if (!ddpPacket) return 1;
+      }
+      uint8_t *p = ddpPacket;
 
-        if (!ddpUdp.beginPacket(client, DDP_DEFAULT_PORT)) {  // port defined in ESPAsyncE131.h
-          DEBUG_PRINTLN(F("WiFiUDP.beginPacket returned an error"));
-          return 1; // problem
-        }
+      for (size_t currentPacket = 0; currentPacket <= lastPacket; currentPacket++) {
+        if (packetMask && !(packetMask[currentPacket >> 3] & (1 << (currentPacket & 7)))) continue; // unchanged, receiver keeps previous data
+
+        // there are 3 channels per RGB pixel
+        uint32_t channel = currentPacket * DDP_CHANNELS_PER_PACKET; // TODO: allow specifying the start channel
+
+        if (sequenceNumber > 15) sequenceNumber = 0;
 
         // the amount of data is AFTER the header in the current packet
         size_t packetSize = DDP_CHANNELS_PER_PACKET;
 
         uint8_t flags = DDP_FLAGS1_VER1;
-        if (currentPacket == (packetCount - 1U)) {
+        if (currentPacket == lastPacket) {
           // last packet, set the push flag
           // TODO: determine if we want to send an empty push packet to each destination after sending the pixel data
           flags = DDP_FLAGS1_VER1 | DDP_FLAGS1_PUSH;
-          if (channelCount % DDP_CHANNELS_PER_PACKET) {
-            packetSize = channelCount % DDP_CHANNELS_PER_PACKET;
-          }
+        }
+        if (currentPacket == (packetCount - 1U) && (channelCount % DDP_CHANNELS_PER_PACKET)) {
+          packetSize = channelCount % DDP_CHANNELS_PER_PACKET;
         }
 
         // write the header
-        /*0*/ddpUdp.write(flags);
-        /*1*/ddpUdp.write(sequenceNumber++ & 0x0F); // sequence may be unnecessary unless we are sending twice (as requested in Sync settings)
-        /*2*/ddpUdp.write(isRGBW ?  DDP_TYPE_RGBW32 : DDP_TYPE_RGB24);
-        /*3*/ddpUdp.write(DDP_ID_DISPLAY);
+        p[0] = flags;
+        p[1] = sequenceNumber++ & 0x0F; // sequence may be unnecessary unless we are sending twice (as requested in Sync settings)
+        p[2] = isRGBW ?  DDP_TYPE_RGBW32 : DDP_TYPE_RGB24;
+        p[3] = DDP_ID_DISPLAY;
         // data offset in bytes, 32-bit number, MSB first
-        /*4*/ddpUdp.write(0xFF & (channel >> 24));
-        /*5*/ddpUdp.write(0xFF & (channel >> 16));
-        /*6*/ddpUdp.write(0xFF & (channel >>  8));
-        /*7*/ddpUdp.write(0xFF & (channel      ));
+        p[4] = 0xFF & (channel >> 24);
+        p[5] = 0xFF & (channel >> 16);
+        p[6] = 0xFF & (channel >>  8);
+        p[7] = 0xFF & (channel      );
         // data length in bytes, 16-bit number, MSB first
-        /*8*/ddpUdp.write(0xFF & (packetSize >> 8));
-        /*9*/ddpUdp.write(0xFF & (packetSize     ));
-
-        // write the colors, the write write(const uint8_t *buffer, size_t size)
-        // function is just a loop internally too
-        for (size_t i = 0; i < packetSize; i += (isRGBW?4:3)) {
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // R
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // G
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // B
-          if (isRGBW) ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // W
-        }
+        writeU16(p + 8, packetSize);
 
-        if (!ddpUdp.endPacket()) {
-          DEBUG_PRINTLN(F("WiFiUDP.endPacket returned an error"));
-          return 1; // problem
-        }
+        // write the colors
+        color_scale_bytes(p + DDP_HEADER_LEN, buffer + channel, packetSize, bri);
 
-        channel += packetSize;
+        if (!sendPacket(client, DDP_DEFAULT_PORT, p, DDP_HEADER_LEN + packetSize)) return 1; // problem
       }
     } break;
 
     case 1: //E1.31
     {
+      // calculate the number of UDP packets we need to send, one universe each
+      const size_t channelCount = length * (isRGBW?4:3); // 1 channel for every R,G,B,(W?) value
+      const size_t E131_CHANNELS_PER_PACKET = isRGBW?512:510; // 512/4=128 RGBW LEDs, 510/3=170 RGB LEDs
+      const size_t packetCount = ((channelCount-1)/E131_CHANNELS_PER_PACKET)+1;
+
+      if (!e131Packet) {
+        e131Packet = (uint8_t*) malloc(E131_HEADER_LEN + 512);
+        if (!e131Packet) return 1;
+        e131InitPacket(e131Packet);
+      }
+      uint8_t *p = e131Packet;
+      // per frame: source name, priority, synchronization address and sequence number are the same for all universes
+      strncpy(reinterpret_cast<char*>(p + E131_FRAME_SOURCE), serverDescription, 63);
+      p[E131_FRAME_PRIORITY] = e131OutPriority;
+      writeU16(p + E131_FRAME_RESERVED, e131OutSyncUniverse);
+      p[E131_FRAME_SEQ] = e131Sequence++;
+
+      size_t bufferOffset = 0;
+      for (size_t currentPacket = 0; currentPacket < packetCount; currentPacket++) {
+        size_t universe = e131OutUniverse + universeOffset + currentPacket;
+        if (universe > E131_MAX_OUT_UNIVERSE) break;
+
+        size_t packetSize = E131_CHANNELS_PER_PACKET;
+        if (currentPacket == (packetCount - 1U) && (channelCount % E131_CHANNELS_PER_PACKET)) {
+          packetSize = channelCount % E131_CHANNELS_PER_PACKET; // last packet
+        }
+        size_t packetLen = E131_HEADER_LEN + packetSize;
+
+        writeU16(p + E131_ROOT_FLENGTH,   0x7000 | (packetLen - E131_ROOT_FLENGTH));
+        writeU16(p + E131_FRAME_FLENGTH,  0x7000 | (packetLen - E131_FRAME_FLENGTH));
+        writeU16(p + E131_FRAME_UNIVERSE, universe);
+        writeU16(p + E131_DMP_FLENGTH,    0x7000 | (packetLen - E131_DMP_FLENGTH));
+        writeU16(p + E131_DMP_COUNT,      packetSize + 1); // including start code
+
+        color_scale_bytes(p + E131_HEADER_LEN, buffer + bufferOffset, packetSize, bri);
+        bufferOffset += packetSize;
+
+        if (!sendPacket(client, E131_DEFAULT_PORT, p, packetLen)) return 1;
+      }
+
+      // receivers holding universes back until synchronization packet arrives output them all at once
+      if (e131OutSyncUniverse) {
+        uint8_t sync[E131_SYNC_PACKET_LEN];
+        memcpy(sync, p, E131_FRAME_FLENGTH); // root layer incl. CID
+        memset(sync + E131_FRAME_FLENGTH, 0, E131_SYNC_PACKET_LEN - E131_FRAME_FLENGTH);
+        writeU16(sync + E131_ROOT_FLENGTH, 0x7000 | (E131_SYNC_PACKET_LEN - E131_ROOT_FLENGTH));
+        sync[E131_ROOT_VECTOR+3] = 0x08; // VECTOR_ROOT_E131_EXTENDED
+        writeU16(sync + E131_FRAME_FLENGTH, 0x7000 | (E131_SYNC_PACKET_LEN - E131_FRAME_FLENGTH));
+        sync[E131_FRAME_VECTOR+3] = 0x01; // VECTOR_E131_EXTENDED_SYNCHRONIZATION
+        sync[E131_FRAME_SOURCE]   = e131SyncSequence++;
+        writeU16(sync + E131_FRAME_SOURCE + 1, e131OutSyncUniverse);
+        if (!sendPacket(client, E131_DEFAULT_PORT, sync, E131_SYNC_PACKET_LEN)) return 1;
+      }
     } break;
 
     case 2: //ArtNet
@@ -799,7 +949,13 @@ uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8
       const size_t ARTNET_CHANNELS_PER_PACKET = isRGBW?512:510; // 512/4=128 RGBW LEDs, 510/3=170 RGB LEDs
       const size_t packetCount = ((channelCount-1)/ARTNET_CHANNELS_PER_PACKET)+1;
 
-      uint32_t channel = 0; 
+      if (!artnetPacket) {
+        artnetPacket = (uint8_t*) malloc(ART_NET_HEADER_SIZE + 6 + 512);
+        if (!artnetPacket) return 1;
+        memcpy_P(artnetPacket, ART_NET_HEADER, ART_NET_HEADER_SIZE); // This doesn't change. Hard coded ID, OpCode, and protocol version.
+      }
+      uint8_t *p = artnetPacket;
+
       size_t bufferOffset = 0;
 
       sequenceNumber++;
@@ -808,11 +964,6 @@ uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8
 
         if (sequenceNumber > 255) sequenceNumber = 0;
 
-        if (!ddpUdp.beginPacket(client, ARTNET_DEFAULT_PORT)) {
-          DEBUG_PRINTLN(F("Art-Net WiFiUDP.beginPacket returned an error"));
-          return 1; // borked
-        }
-
         size_t packetSize = ARTNET_CHANNELS_PER_PACKET;
 
         if (currentPacket == (packetCount - 1U)) {
@@ -822,28 +973,17 @@ uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8
           }
         }
 
-        byte header_buffer[ART_NET_HEADER_SIZE];
-        memcpy_P(header_buffer, ART_NET_HEADER, ART_NET_HEADER_SIZE);
-        ddpUdp.write(header_buffer, ART_NET_HEADER_SIZE); // This doesn't change. Hard coded ID, OpCode, and protocol version.
-        ddpUdp.write(sequenceNumber & 0xFF); // sequence number. 1..255
-        ddpUdp.write(0x00); // physical - more an FYI, not really used for anything. 0..3
-        ddpUdp.write((currentPacket) & 0xFF); // Universe LSB. 1 full packet == 1 full universe, so just use current packet number.
-        ddpUdp.write(0x00); // Universe MSB, unused.
-        ddpUdp.write(0xFF & (packetSize >> 8)); // 16-bit length of channel data, MSB
-        ddpUdp.write(0xFF & (packetSize     )); // 16-bit length of channel data, LSB
-
-        for (size_t i = 0; i < packetSize; i += (isRGBW?4:3)) {
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // R
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // G
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // B
-          if (isRGBW) ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // W
-        }
+        p[ART_NET_HEADER_SIZE]   = sequenceNumber & 0xFF; // sequence number. 1..255
+        p[ART_NET_HEADER_SIZE+1] = 0x00; // physical - more an FYI, not really used for anything. 0..3
+        size_t universe = universeOffset + currentPacket; // 1 full packet == 1 full universe
+        p[ART_NET_HEADER_SIZE+2] = universe & 0xFF; // Universe LSB (sub-net and universe)
+        p[ART_NET_HEADER_SIZE+3] = (universe >> 8) & 0x7F; // Universe MSB (net)
+        writeU16(p + ART_NET_HEADER_SIZE + 4, packetSize); // 16-bit length of channel data, MSB first
 
-        if (!ddpUdp.endPacket()) {
-          DEBUG_PRINTLN(F("Art-Net WiFiUDP.endPacket returned an error"));
-          return 1; // borked
-        }
-        channel += packetSize;
+        color_scale_bytes(p + ART_NET_HEADER_SIZE + 6, buffer + bufferOffset, packetSize, bri);
+        bufferOffset += packetSize;
+
+        if (!sendPacket(client, ARTNET_DEFAULT_PORT, p, ART_NET_HEADER_SIZE + 6 + packetSize)) return 1; // borked
       }
     } break;
   }
@@ -48,11 +48,14 @@ void WLED::loop()
   static size_t        avgStripMillis = 0;
   unsigned long        stripMillis;
   #endif
+  unsigned long loopStart = micros();
+  unsigned long phaseStart;
 
   handleTime();
   #ifndef WLED_DISABLE_INFRARED
   handleIR();        // 2nd call to function needed for ESP32 to return valid results -- should be good for ESP8266, too
   #endif
+  phaseStart = micros();
   handleConnection();
   #ifndef WLED_DISABLE_ESPNOW
   handleRemote();
@@ -60,16 +63,19 @@ void WLED::loop()
   handleSerial();
   handleImprovWifiScan();
   handleNotifications();
+  unsigned long netMicros = micros() - phaseStart;
   handleTransitions();
 #ifdef WLED_ENABLE_DMX
   handleDMX();
 #endif
-  userLoop();
 
   #ifdef WLED_DEBUG
   unsigned long usermodMillis = millis();
   #endif
+  phaseStart = micros();
+  userLoop();
   usermods.loop();
+  usermodTime.add(micros() - phaseStart);
   #ifdef WLED_DEBUG
   usermodMillis = millis() - usermodMillis;
   avgUsermodMillis += usermodMillis;
@@ -82,8 +88,11 @@ void WLED::loop()
   handleIR();
   #endif
   #ifndef WLED_DISABLE_ALEXA
+  phaseStart = micros();
   handleAlexa();
+  netMicros += micros() - phaseStart;
   #endif
+  netTime.add(netMicros);
 
   if (doCloseFile) {
     closeFile();
@@ -99,8 +108,10 @@ void WLED::loop()
     #ifndef WLED_DISABLE_OTA
     if (WLED_CONNECTED && aOtaEnabled && !otaLock && correctPIN) ArduinoOTA.handle();
     #endif
+    phaseStart = micros();
     handleNightlight();
     handlePlaylist();
+    unsigned long presetMicros = micros() - phaseStart;
     yield();
 
     #ifndef WLED_DISABLE_HUESYNC
@@ -108,11 +119,16 @@ void WLED::loop()
     yield();
     #endif
 
+    phaseStart = micros();
     handlePresets();
+    presetTime.add(presetMicros + micros() - phaseStart);
     yield();
 
-    if (!offMode || strip.isOffRefreshRequired())
+    if (!offMode || strip.isOffRefreshRequired() || strip.isBenchmarkPending()) {
+      phaseStart = micros();
       strip.service();
+      stripTime.add(micros() - phaseStart);
+    }
     #ifdef ESP8266
     else if (!noWifiSleep)
       delay(1); //required to make sure ESP enters modem sleep (see #1184)
@@ -206,6 +222,14 @@ void WLED::loop()
   if (doReboot && (!doInitBusses || !doSerializeConfig)) // if busses have to be inited & saved, wait until next iteration
     reset();
 
+  loopTime.add(micros() - loopStart);
+
+  // nothing to render: sleep until next frame is due (lets FreeRTOS idle task run or ESP8266 enter modem sleep)
+  if (idleSleep && !realtimeMode && !doInitBusses && !doReboot) {
+    uint32_t idle = (offMode && !strip.isOffRefreshRequired() && !strip.isBenchmarkPending()) ? WLED_MAX_IDLE_SLEEP : strip.getTimeToNextFrame();
+    if (idle > 1) delay(MIN(idle, WLED_MAX_IDLE_SLEEP));
+  }
+
 // DEBUG serial logging (every 30s)
 #ifdef WLED_DEBUG
   loopMillis = millis() - loopMillis;
@@ -555,6 +579,7 @@ void WLED::initAP(bool resetAP)
     if (udpPort2 > 0 && udpPort2 != ntpLocalPort && udpPort2 != udpPort && udpPort2 != udpRgbPort) {
       udp2Connected = notifier2Udp.begin(udpPort2);
     }
+    realtimeRxBegin();
     e131.begin(false, e131Port, e131Universe, E131_MAX_UNIVERSE_COUNT);
     ddp.begin(false, DDP_DEFAULT_PORT);
 
@@ -774,6 +799,7 @@ void WLED::initInterfaces()
   if (ntpEnabled)
     ntpConnected = ntpUdp.begin(ntpLocalPort);
 
+  realtimeRxBegin();
   e131.begin(e131Multicast, e131Port, e131Universe, E131_MAX_UNIVERSE_COUNT);
   ddp.begin(false, DDP_DEFAULT_PORT);
   reconnectHue();
@@ -337,6 +337,10 @@ WLED_GLOBAL bool useGlobalLedBuffer _INIT(false); // double buffering disabled o
 #else
 WLED_GLOBAL bool useGlobalLedBuffer _INIT(true);  // double buffering enabled on ESP32
 #endif
+WLED_GLOBAL bool idleSleep          _INIT(false); // loop() sleeps until next effect frame is due (saves power, adds up to WLED_MAX_IDLE_SLEEP ms latency)
+#ifndef WLED_MAX_IDLE_SLEEP
+  #define WLED_MAX_IDLE_SLEEP 10                     // ms, keeps polled network services (UDP sync, DNS, OTA) responsive
+#endif
 WLED_GLOBAL bool correctWB          _INIT(false); // CCT color correction of RGB color
 WLED_GLOBAL bool cctFromRgb         _INIT(false); // CCT is calculated from RGB instead of using seg.cct
 WLED_GLOBAL bool gammaCorrectCol    _INIT(true);  // use gamma correction on colors
@@ -401,6 +405,12 @@ WLED_GLOBAL char alexaInvocationName[33] _INIT("Light");          // speech cont
 WLED_GLOBAL byte alexaNumPresets _INIT(0);                        // number of presets to expose to Alexa, starting from preset 1, up to 9
 
 WLED_GLOBAL uint16_t realtimeTimeoutMs _INIT(2500);               // ms timeout of realtime mode before returning to normal mode
+WLED_GLOBAL uint16_t udpDrainBudgetUs _INIT(2000);                // us per loop spent handling pending notifier/realtime UDP packets (at least one is handled)
+WLED_GLOBAL uint32_t udpPacketsReceived _INIT(0);                 // notifier/realtime UDP packets taken from the sockets
+WLED_GLOBAL uint32_t udpPacketsMalformed _INIT(0);                // of those, packets discarded as oversized or truncated (packets lost in the network stack are not visible through WiFiUDP)
+WLED_GLOBAL uint16_t udpPacketsPerLoop _INIT(0);                  // packets handled in the last loop pass (not the socket queue depth)
+WLED_GLOBAL uint16_t udpPacketsPerLoopMax _INIT(0);               // most packets handled in a single loop pass
+WLED_GLOBAL uint32_t udpDrainBudgetExits _INIT(0);                // loop passes that stopped on the time budget with packets possibly still pending
 WLED_GLOBAL int arlsOffset _INIT(0);                              // realtime LED offset
 WLED_GLOBAL bool receiveDirect _INIT(true);                       // receive UDP realtime
 WLED_GLOBAL bool arlsDisableGammaCorrection _INIT(true);          // activate if gamma correction is handled by the source
@@ -424,6 +434,11 @@ WLED_GLOBAL uint16_t DMXSegmentSpacing _INIT(0);                  // Number of v
 WLED_GLOBAL byte e131LastSequenceNumber[E131_MAX_UNIVERSE_COUNT]; // to detect packet loss
 WLED_GLOBAL bool e131Multicast _INIT(false);                      // multicast or unicast
 WLED_GLOBAL bool e131SkipOutOfSequence _INIT(false);              // freeze instead of flickering
+WLED_GLOBAL uint32_t e131StagedFrames _INIT(0);                   // multi-universe or synchronized frames applied at once
+WLED_GLOBAL uint32_t e131IncompleteFrames _INIT(0);               // of those, frames missing universes or their sync packet
+WLED_GLOBAL uint16_t e131OutUniverse _INIT(1);                    // first universe sent by E1.31 network busses (consecutive universes follow, each bus continues after the previous one)
+WLED_GLOBAL byte e131OutPriority _INIT(100);                      // priority of sent E1.31 data (0-200)
+WLED_GLOBAL uint16_t e131OutSyncUniverse _INIT(0);                // E1.31 synchronization universe for sent data (0 = no sync packets)
 WLED_GLOBAL uint16_t pollReplyCount _INIT(0);                     // count number of replies for ArtPoll node report
 
 // mqtt
@@ -694,6 +709,14 @@ WLED_GLOBAL WiFiUDP ntpUdp;
 WLED_GLOBAL ESPAsyncE131 e131 _INIT_N(((handleE131Packet)));
 WLED_GLOBAL ESPAsyncE131 ddp  _INIT_N(((handleE131Packet)));
 WLED_GLOBAL bool e131NewData _INIT(false);
+WLED_GLOBAL uint8_t ddpIdMode _INIT(DDP_ID_MODE_STRIP);           // routing of received DDP destination IDs 2-245 to segments or busses
+WLED_GLOBAL bool realtimeRxTask _INIT(false);                     // ESP32: decode E1.31/Art-Net/DDP on a dedicated task into a frame ring (applied on reboot)
+WLED_GLOBAL uint32_t rtRxPacketsDropped _INIT(0);                 // packets not queued for the receive task (queue full)
+WLED_GLOBAL uint32_t rtRxFramesSkipped _INIT(0);                  // decoded frames replaced by a newer one before being shown
+WLED_GLOBAL uint8_t  realtimeJitterFrames _INIT(0);               // ESP32: frames buffered to smooth realtime network jitter (0 = off, uses receive task, applied on reboot)
+WLED_GLOBAL uint16_t realtimeJitterLatency _INIT(0);              // ms added to jitter buffer delay
+WLED_GLOBAL uint32_t rtJitterLate _INIT(0);                       // frames arriving more than half an interval behind the sender cadence
+WLED_GLOBAL uint32_t rtJitterEarly _INIT(0);                      // frames arriving more than half an interval ahead of it
 
 // led fx library object
 WLED_GLOBAL BusManager busses _INIT(BusManager());
@@ -749,6 +772,13 @@ WLED_GLOBAL int8_t spi_sclk  _INIT(SPISCLKPIN);
 WLED_GLOBAL StaticJsonDocument<JSON_BUFFER_SIZE> doc;
 WLED_GLOBAL volatile uint8_t jsonBufferLock _INIT(0);
 
+// main loop phase durations (us), reported in JSON info
+WLED_GLOBAL TimingStat loopTime;    // whole loop
+WLED_GLOBAL TimingStat netTime;     // connection, remote, serial, UDP notifications, Alexa
+WLED_GLOBAL TimingStat usermodTime;
+WLED_GLOBAL TimingStat presetTime;  // nightlight, playlist & presets
+WLED_GLOBAL TimingStat stripTime;   // effects, ABL & show()
+
 // enable additional debug output
 #if defined(WLED_DEBUG_HOST)
   #include "net_debug.h"